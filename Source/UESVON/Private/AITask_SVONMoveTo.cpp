@@ -9,6 +9,7 @@
 #include "UESVON/Public/UESVON.h"
 #include "UESVON/Public/SVONNavigationComponent.h"
 #include "UESVON/Public/SVONNavigationPath.h"
+#include "UESVON/Public/SVONPathQuery.h"
 #include "UESVON/Public/SVONVolume.h"
 #include "VisualLogger/VisualLogger.h"
 
@@ -41,8 +42,6 @@ UAITask_SVONMoveTo* UAITask_SVONMoveTo::SVONAIMoveTo(AAIController* Controller,
 	if (MyTask)
 	{
 		MyTask->myUseAsyncPathfinding = aUseAsyncPathfinding;
-		// We need to tick the task if we're using async, to check when results are back
-		MyTask->bTickingTask = aUseAsyncPathfinding;
 
 		FAIMoveRequest MoveReq;
 		if (InGoalActor)
@@ -78,7 +77,6 @@ void UAITask_SVONMoveTo::SetUp(AAIController* Controller, const FAIMoveRequest&
 	OwnerController = Controller;
 	MoveRequest = InMoveRequest;
 	myUseAsyncPathfinding = aUseAsyncPathfinding;
-	bTickingTask = aUseAsyncPathfinding;
 
 	// Fail if no nav component
 	myNavComponent = Cast<USVONNavigationComponent>(GetOwnerActor()->GetComponentByClass(USVONNavigationComponent::StaticClass()));
@@ -99,12 +97,6 @@ void UAITask_SVONMoveTo::SetContinuousGoalTracking(bool bEnable)
 	bUseContinuousTracking = bEnable;
 }
 
-void UAITask_SVONMoveTo::TickTask(float DeltaTime)
-{
-	if (myAsyncTaskComplete)
-		HandleAsyncPathTaskComplete();
-}
-
 void UAITask_SVONMoveTo::FinishMoveTask(EPathFollowingResult::Type InResult)
 {
 	if (MoveRequestID.IsValid())
@@ -174,7 +166,17 @@ void UAITask_SVONMoveTo::PerformMove()
 	// If we're ready to path, then request the path
 	if (myResult.Code == ESVONPathfindingRequestResult::ReadyToPath)
 	{
-		myUseAsyncPathfinding ? RequestPathAsync() : RequestPathSynchronous();
+		// Following a moving actor, so the last search is mostly still good
+		const bool useIncremental = bUseContinuousTracking && MoveRequest.IsMoveToActorRequest() && myNavComponent->UseIncrementalReplanning;
+
+		if (myUseAsyncPathfinding)
+		{
+			RequestPathAsync(useIncremental);
+		}
+		else
+		{
+			useIncremental ? RequestPathIncremental() : RequestPathSynchronous();
+		}
 
 		switch (myResult.Code)
 		{
@@ -188,7 +190,6 @@ void UAITask_SVONMoveTo::PerformMove()
 			break;
 		case ESVONPathfindingRequestResult::Deferred: // Async...we're waiting on the task to return
 			MoveRequestID = myResult.MoveId;
-			myAsyncTaskComplete = false;
 			break;
 		default:
 			checkNoEntry();
@@ -331,7 +332,17 @@ void UAITask_SVONMoveTo::RequestPathSynchronous()
 	return;
 }
 
-void UAITask_SVONMoveTo::RequestPathAsync()
+void UAITask_SVONMoveTo::RequestPathIncremental()
+{
+	myResult.Code = ESVONPathfindingRequestResult::Failed;
+
+	if (myNavComponent->FindPathIncremental(myNavComponent->GetPawnPosition(), MoveRequest.GetGoalActor()->GetActorLocation(), &mySVONPath))
+	{
+		myResult.Code = ESVONPathfindingRequestResult::Success;
+	}
+}
+
+void UAITask_SVONMoveTo::RequestPathAsync(bool aUseIncrementalPlanner)
 {
 	myResult.Code = ESVONPathfindingRequestResult::Failed;
 
@@ -340,12 +351,27 @@ void UAITask_SVONMoveTo::RequestPathAsync()
 	if (!svonNavComponent)
 		return;
 
-	myAsyncTaskComplete = false;
+	CancelPathQuery();
 
 	// Request the async path
-	svonNavComponent->FindPathAsync(myNavComponent->GetPawnPosition(), MoveRequest.IsMoveToActorRequest() ? MoveRequest.GetGoalActor()->GetActorLocation() : MoveRequest.GetGoalLocation(), myAsyncTaskComplete, &mySVONPath);
+	myPathQuery = svonNavComponent->FindPathAsync(myNavComponent->GetPawnPosition(), MoveRequest.IsMoveToActorRequest() ? MoveRequest.GetGoalActor()->GetActorLocation() : MoveRequest.GetGoalLocation(), aUseIncrementalPlanner);
 
-	myResult.Code = ESVONPathfindingRequestResult::Deferred;
+	if (myPathQuery.IsValid())
+	{
+		// Completion is pushed to us, so there's nothing to tick while we wait
+		myPathQuery->OnComplete.BindUObject(this, &UAITask_SVONMoveTo::HandleAsyncPathTaskComplete);
+		myResult.Code = ESVONPathfindingRequestResult::Deferred;
+	}
+}
+
+void UAITask_SVONMoveTo::CancelPathQuery()
+{
+	if (myPathQuery.IsValid())
+	{
+		myPathQuery->OnComplete.Unbind();
+		myPathQuery->Cancel();
+		myPathQuery.Reset();
+	}
 }
 
 /* Requests the move, based on the current path */
@@ -387,13 +413,29 @@ void UAITask_SVONMoveTo::RequestMove()
 	}
 }
 
-void UAITask_SVONMoveTo::HandleAsyncPathTaskComplete()
+void UAITask_SVONMoveTo::HandleAsyncPathTaskComplete(const FSVONPathQuerySharedPtr& aQuery)
 {
+	// Only the query we're waiting on, anything older was superseded
+	if (aQuery != myPathQuery)
+		return;
+
+	// Flag that we've processed the query before anything can start another
+	const FSVONPathQuerySharedPtr query = myPathQuery;
+	myPathQuery.Reset();
+
+	if (!query->IsSuccess() || !mySVONPath.IsValid())
+	{
+		FinishMoveTask(EPathFollowingResult::Invalid);
+		return;
+	}
+
+	// The query owns the path it found, take the points into ours
+	mySVONPath->GetPathPoints() = MoveTemp(query->GetPath()->GetPathPoints());
+	mySVONPath->SetIsReady(true);
+
 	myResult.Code = ESVONPathfindingRequestResult::Success;
 	// Request the move
 	RequestMove();
-	// Flag that we've processed the task
-	myAsyncTaskComplete = false;
 }
 
 void UAITask_SVONMoveTo::ResetPaths()
@@ -504,6 +546,9 @@ void UAITask_SVONMoveTo::OnDestroy(bool bInOwnerFinished)
 {
 	Super::OnDestroy(bInOwnerFinished);
 
+	// Nobody is going to use the result now
+	CancelPathQuery();
+
 	ResetObservers();
 	ResetTimers();
 
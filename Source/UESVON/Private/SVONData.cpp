@@ -0,0 +1,167 @@
+#include "UESVON/Public/SVONData.h"
+#include "Algo/BinarySearch.h"
+#include "Async/ParallelFor.h"
+
+void FSVONData::BuildPositionCache(bool aForceSingleThread)
+{
+	ResetPositionCache();
+
+	int32 numNodes = 0;
+	myPositionOffsets.SetNumUninitialized(myLayers.Num());
+	for (int32 i = 0; i < myLayers.Num(); i++)
+	{
+		myPositionOffsets[i] = numNodes;
+		numNodes += myLayers[i].Num();
+	}
+
+	myPositionsX.SetNumUninitialized(numNodes);
+	myPositionsY.SetNumUninitialized(numNodes);
+	myPositionsZ.SetNumUninitialized(numNodes);
+	myLayerZeroVoxelSize = GetVoxelSize(0);
+
+	for (int32 i = 0; i < myLayers.Num(); i++)
+	{
+		const TArray<FSVONNode>& layer = myLayers[i];
+		const int32 offset = myPositionOffsets[i];
+
+		ParallelFor(layer.Num(), [&](int32 aNodeIndex) {
+			FVector position;
+			GetNodePosition(i, layer[aNodeIndex].myCode, position);
+			myPositionsX[offset + aNodeIndex] = position.X;
+			myPositionsY[offset + aNodeIndex] = position.Y;
+			myPositionsZ[offset + aNodeIndex] = position.Z;
+		}, aForceSingleThread);
+	}
+}
+
+const FSVONNode& FSVONData::GetNode(const FSVONLink& aLink) const
+{
+	if (aLink.GetLayerIndex() < 14)
+	{
+		return GetLayer(aLink.GetLayerIndex())[aLink.GetNodeIndex()];
+	}
+	else
+	{
+		return myLayers.Last()[0];
+	}
+}
+
+bool FSVONData::GetIndexForCode(uint8 aLayer, uint64 aCode, int32& oIndex) const
+{
+	const TArray<FSVONNode>& layer = GetLayer(aLayer);
+
+	// Layers are always built in ascending morton order, so we can binary search them
+	const int32 index = Algo::LowerBoundBy(layer, aCode, &FSVONNode::myCode);
+
+	if (index < layer.Num() && layer[index].myCode == aCode)
+	{
+		oIndex = index;
+		return true;
+	}
+
+	return false;
+}
+
+const FSVONLeafNode& FSVONData::GetLeafNode(int32 aIndex) const
+{
+	return myLeafNodes[aIndex];
+}
+
+float FSVONData::GetVoxelSize(uint8 aLayer) const
+{
+	return (myExtent.X / FMath::Pow(2, GetNumLayers() - 1)) * (FMath::Pow(2.0f, aLayer + 1));
+}
+
+bool FSVONData::GetNodePosition(uint8 aLayer, uint64 aCode, FVector& oPosition) const
+{
+	const float voxelSize = GetVoxelSize(aLayer);
+	uint32 x, y, z;
+	FSVONMorton::Decode(aCode, x, y, z);
+	oPosition = myOrigin - myExtent + FVector(x * voxelSize, y * voxelSize, z * voxelSize) + FVector(voxelSize * 0.5f);
+	return true;
+}
+
+// Gets the position of a given link. Returns true if the link is open, false if blocked
+bool FSVONData::GetLinkPosition(const FSVONLink& aLink, FVector& oPosition) const
+{
+	const FSVONNode& node = GetLayer(aLink.GetLayerIndex())[aLink.GetNodeIndex()];
+
+	if (HasPositionCache())
+	{
+		const int32 index = myPositionOffsets[aLink.GetLayerIndex()] + aLink.GetNodeIndex();
+		oPosition = FVector(myPositionsX[index], myPositionsY[index], myPositionsZ[index]);
+	}
+	else
+	{
+		GetNodePosition(aLink.GetLayerIndex(), node.myCode, oPosition);
+	}
+
+	// If this is layer 0, and there are valid children
+	if (aLink.GetLayerIndex() == 0 && node.myFirstChild.IsValid())
+	{
+		const float voxelSize = HasPositionCache() ? myLayerZeroVoxelSize : GetVoxelSize(0);
+		oPosition += USVONStatics::leafSubnodeOffsets[aLink.GetSubnodeIndex()] * voxelSize;
+		const FSVONLeafNode& leafNode = GetLeafNode(node.myFirstChild.myNodeIndex);
+		bool isBlocked = leafNode.GetNode(aLink.GetSubnodeIndex());
+		return !isBlocked;
+	}
+	return true;
+}
+
+void FSVONData::GetLeafNeighbours(const FSVONLink& aLink, TArray<FSVONLink>& oNeighbours) const
+{
+	ForEachLeafNeighbour(aLink, [&oNeighbours](const FSVONLink& aNeighbour) { oNeighbours.Add(aNeighbour); });
+}
+
+void FSVONData::GetNeighbours(const FSVONLink& aLink, TArray<FSVONLink>& oNeighbours) const
+{
+	ForEachNeighbour(aLink, [&oNeighbours](const FSVONLink& aNeighbour) { oNeighbours.Add(aNeighbour); });
+}
+
+bool FSVONData::IsLeafVoxelBlocked(uint32 aX, uint32 aY, uint32 aZ) const
+{
+	uint32 emptySize;
+	return IsLeafVoxelBlocked(aX, aY, aZ, emptySize);
+}
+
+bool FSVONData::IsLeafVoxelBlocked(uint32 aX, uint32 aY, uint32 aZ, uint32& oEmptySize) const
+{
+	oEmptySize = 0;
+
+	const int32 numLayers = GetNumLayers();
+	if (numLayers == 0)
+		return true;
+
+	const uint32 leafVoxelsPerSide = 4u << (numLayers - 1);
+	if (aX >= leafVoxelsPerSide || aY >= leafVoxelsPerSide || aZ >= leafVoxelsPerSide)
+		return true;
+
+	// The bottom 6 bits are the subnode within the leaf, the rest is the layer 0 code
+	const uint64 leafCode = FSVONMorton::Encode(aX, aY, aZ);
+	const uint64 code = leafCode >> 6;
+
+	// The top layer is dense, so its node index is its code. Below that, children are contiguous and in morton order,
+	// so we can go straight to the right child without searching
+	int32 layerIndex = numLayers - 1;
+	int32 nodeIndex = static_cast<int32>(code >> (layerIndex * 3));
+
+	while (true)
+	{
+		const FSVONNode& node = GetLayer(layerIndex)[nodeIndex];
+
+		if (!node.HasChildren())
+		{
+			oEmptySize = 4u << layerIndex;
+			return false;
+		}
+
+		if (layerIndex == 0)
+		{
+			oEmptySize = 1;
+			return GetLeafNode(node.myFirstChild.GetNodeIndex()).GetNode(leafCode & 63);
+		}
+
+		layerIndex--;
+		nodeIndex = node.myFirstChild.GetNodeIndex() + static_cast<int32>((code >> (layerIndex * 3)) & 7);
+	}
+}
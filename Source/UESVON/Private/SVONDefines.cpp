@@ -26,6 +26,24 @@ const int32 USVONStatics::dirLeafChildOffsets[6][16] = {
 
 };
 
+const FVector USVONStatics::leafSubnodeOffsets[64] = {
+	FVector(-0.375f, -0.375f, -0.375f), FVector(-0.125f, -0.375f, -0.375f), FVector(-0.375f, -0.125f, -0.375f), FVector(-0.125f, -0.125f, -0.375f),
+	FVector(-0.375f, -0.375f, -0.125f), FVector(-0.125f, -0.375f, -0.125f), FVector(-0.375f, -0.125f, -0.125f), FVector(-0.125f, -0.125f, -0.125f),
+	FVector(0.125f, -0.375f, -0.375f), FVector(0.375f, -0.375f, -0.375f), FVector(0.125f, -0.125f, -0.375f), FVector(0.375f, -0.125f, -0.375f),
+	FVector(0.125f, -0.375f, -0.125f), FVector(0.375f, -0.375f, -0.125f), FVector(0.125f, -0.125f, -0.125f), FVector(0.375f, -0.125f, -0.125f),
+	FVector(-0.375f, 0.125f, -0.375f), FVector(-0.125f, 0.125f, -0.375f), FVector(-0.375f, 0.375f, -0.375f), FVector(-0.125f, 0.375f, -0.375f),
+	FVector(-0.375f, 0.125f, -0.125f), FVector(-0.125f, 0.125f, -0.125f), FVector(-0.375f, 0.375f, -0.125f), FVector(-0.125f, 0.375f, -0.125f),
+	FVector(0.125f, 0.125f, -0.375f), FVector(0.375f, 0.125f, -0.375f), FVector(0.125f, 0.375f, -0.375f), FVector(0.375f, 0.375f, -0.375f),
+	FVector(0.125f, 0.125f, -0.125f), FVector(0.375f, 0.125f, -0.125f), FVector(0.125f, 0.375f, -0.125f), FVector(0.375f, 0.375f, -0.125f),
+	FVector(-0.375f, -0.375f, 0.125f), FVector(-0.125f, -0.375f, 0.125f), FVector(-0.375f, -0.125f, 0.125f), FVector(-0.125f, -0.125f, 0.125f),
+	FVector(-0.375f, -0.375f, 0.375f), FVector(-0.125f, -0.375f, 0.375f), FVector(-0.375f, -0.125f, 0.375f), FVector(-0.125f, -0.125f, 0.375f),
+	FVector(0.125f, -0.375f, 0.125f), FVector(0.375f, -0.375f, 0.125f), FVector(0.125f, -0.125f, 0.125f), FVector(0.375f, -0.125f, 0.125f),
+	FVector(0.125f, -0.375f, 0.375f), FVector(0.375f, -0.375f, 0.375f), FVector(0.125f, -0.125f, 0.375f), FVector(0.375f, -0.125f, 0.375f),
+	FVector(-0.375f, 0.125f, 0.125f), FVector(-0.125f, 0.125f, 0.125f), FVector(-0.375f, 0.375f, 0.125f), FVector(-0.125f, 0.375f, 0.125f),
+	FVector(-0.375f, 0.125f, 0.375f), FVector(-0.125f, 0.125f, 0.375f), FVector(-0.375f, 0.375f, 0.375f), FVector(-0.125f, 0.375f, 0.375f),
+	FVector(0.125f, 0.125f, 0.125f), FVector(0.375f, 0.125f, 0.125f), FVector(0.125f, 0.375f, 0.125f), FVector(0.375f, 0.375f, 0.125f),
+	FVector(0.125f, 0.125f, 0.375f), FVector(0.375f, 0.125f, 0.375f), FVector(0.125f, 0.375f, 0.375f), FVector(0.375f, 0.375f, 0.375f)};
+
 const FColor USVONStatics::myLayerColors[] = {FColor::Orange, FColor::Yellow, FColor::White, FColor::Blue, FColor::Turquoise, FColor::Cyan, FColor::Emerald, FColor::Orange};
 
 const FColor USVONStatics::myLinkColors[] = {FColor(0xFF000000), FColor(0xFF444444), FColor(0xFF888888), FColor(0xFFBBBBBB), FColor(0xFFFFFFFF), FColor(0xFF999999), FColor(0xFF777777), FColor(0xFF555555)};
\ No newline at end of file
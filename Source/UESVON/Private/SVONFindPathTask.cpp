@@ -3,9 +3,28 @@
 
 void FSVONFindPathTask::DoWork()
 {
-	FSVONPathFinder pathFinder(myVolume, mySettings);
+	// It may have been cancelled while it sat in the thread pool's queue
+	if (!myQuery->IsCancelled())
+	{
+		int result = 0;
 
-	int result = pathFinder.FindPath(myStart, myTarget, myStartPos, myTargetPos, myPath);
+		if (myPlanner.IsValid())
+		{
+			result = myPlanner->FindPath(myData, mySettings, myStart, myTarget, myStartPos, myTargetPos, &myQuery->myPath, &myQuery->myIsCancelled);
+		}
+		else
+		{
+			FSVONPathFinder pathFinder(myData, mySettings);
+			pathFinder.SetCancelFlag(&myQuery->myIsCancelled);
 
-	myCompleteFlag = true;
+			result = pathFinder.FindPath(myStart, myTarget, myStartPos, myTargetPos, &myQuery->myPath);
+		}
+
+		myQuery->myIsSuccess = result != 0 && !myQuery->IsCancelled();
+	}
+
+	// The scheduler may go away as soon as we're finished, so its queue has to come first
+	myFinishedQueue.Enqueue(myQuery);
+	myQuery->myIsFinished = true;
+	myQuery->myFinishedEvent->Trigger();
 }
@@ -0,0 +1,29 @@
+#include "UESVON/Public/SVONGenerateTask.h"
+#include "UESVON/Public/SVONVolume.h"
+#include "Async/Async.h"
+
+void FSVONGenerateTask::ReportProgress(float aProgress) const
+{
+	TWeakObjectPtr<ASVONVolume> volume = myWeakVolume;
+	AsyncTask(ENamedThreads::GameThread, [volume, aProgress]() {
+		// Anything still queued once generation has finished is out of date
+		if (volume.IsValid() && volume->IsGenerating())
+		{
+			volume->OnGenerationProgress.Broadcast(volume.Get(), aProgress);
+		}
+	});
+}
+
+void FSVONGenerateTask::DoWork()
+{
+	const bool result = myVolume->BuildData();
+
+	// Publishing has to happen on the game thread. The volume may have ended play by the time this runs, and if so, it ignores us
+	TWeakObjectPtr<ASVONVolume> volume = myWeakVolume;
+	AsyncTask(ENamedThreads::GameThread, [volume, result]() {
+		if (volume.IsValid())
+		{
+			volume->FinishGenerationAsync(result);
+		}
+	});
+}
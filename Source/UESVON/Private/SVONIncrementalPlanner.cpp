@@ -0,0 +1,278 @@
+#include "UESVON/Public/SVONIncrementalPlanner.h"
+#include "UESVON.h"
+
+bool FSVONIncrementalPlanner::FindPath(const FSVONDataConstPtr& aData, const FSVONPathFinderSettings& aSettings, const FSVONLink& aStart, const FSVONLink& aGoal, const FVector& aStartPos, const FVector& aTargetPos, FSVONNavPathSharedPtr* oPath, const FThreadSafeBool* aCancelFlag)
+{
+	if (!aData.IsValid() || !oPath || !oPath->IsValid())
+		return false;
+
+	FScopeLock lock(&myLock);
+
+#if WITH_EDITOR
+	const double startTime = FPlatformTime::Seconds();
+#endif
+
+	myNumIterations = 0;
+
+	// If the agent has left everything we searched, none of the tree is worth repairing
+	if (NeedsReset(aData, aSettings) || myStates.Num() > MaxStates || myOpen.Num() > MaxStates || (myStart.IsValid() && !myStates.Contains(aStart)))
+	{
+		Reset();
+	}
+
+	myData = aData;
+	mySettings = aSettings;
+	myPathFinder = FSVONPathFinder(myData, mySettings);
+
+	FVector goalPosition;
+	myData->GetLinkPosition(aGoal, goalPosition);
+
+	if (!myStart.IsValid())
+	{
+		myStart = aStart;
+		myGoal = aGoal;
+		myGoalPosition = goalPosition;
+
+		GetState(myStart).myRhs = 0.f;
+		UpdateState(myStart);
+	}
+	else
+	{
+		// Every key still in the heap was estimated against the old goal, so is now off by at most the distance it moved
+		if (!(aGoal == myGoal))
+		{
+			myKeyModifier += mySettings.myEstimateWeight * myPathFinder.HeuristicScore(myGoalPosition, goalPosition, aGoal);
+			myGoal = aGoal;
+			myGoalPosition = goalPosition;
+		}
+
+		// Re-root the tree on the agent. The old root is now reached like any other link, and anything that relied on it being free gets repaired
+		if (!(aStart == myStart))
+		{
+			const FSVONLink oldStart = myStart;
+			myStart = aStart;
+
+			FState& startState = GetState(myStart);
+			startState.myRhs = 0.f;
+			startState.myParent.SetInvalid();
+			UpdateState(myStart);
+
+			UpdateRhs(oldStart);
+			UpdateState(oldStart);
+		}
+	}
+
+	if (!ComputePath(aCancelFlag))
+	{
+#if WITH_EDITOR
+		UE_LOG(UESVON, Display, TEXT("Incremental replan failed, iterations : %i, states : %i, time : %f ms"), myNumIterations, myStates.Num(), (FPlatformTime::Seconds() - startTime) * 1000.0);
+#endif
+		return false;
+	}
+
+	myPathFinder.BuildPath(myStart, myGoal, aStartPos, aTargetPos, [this](const FSVONLink& aLink) {
+		const FState* state = myStates.Find(aLink);
+		return state ? state->myParent : FSVONLink::GetInvalidLink();
+	}, oPath);
+
+#if WITH_EDITOR
+	UE_LOG(UESVON, Display, TEXT("Incremental replan complete, iterations : %i, states : %i, time : %f ms"), myNumIterations, myStates.Num(), (FPlatformTime::Seconds() - startTime) * 1000.0);
+#endif
+
+	return true;
+}
+
+void FSVONIncrementalPlanner::Reset()
+{
+	myStates.Reset();
+	myOpen.Reset();
+	myStart.SetInvalid();
+	myGoal.SetInvalid();
+	myKeyModifier = 0.f;
+}
+
+bool FSVONIncrementalPlanner::NeedsReset(const FSVONDataConstPtr& aData, const FSVONPathFinderSettings& aSettings) const
+{
+	// Anything that changes the cost of an edge invalidates every g value we have
+	return aData != myData
+		|| aSettings.myUseUnitCost != mySettings.myUseUnitCost
+		|| aSettings.myUnitCost != mySettings.myUnitCost
+		|| aSettings.myEstimateWeight != mySettings.myEstimateWeight
+		|| aSettings.myNodeSizeCompensation != mySettings.myNodeSizeCompensation
+		|| aSettings.myPathCostType != mySettings.myPathCostType;
+}
+
+FSVONIncrementalPlanner::FState& FSVONIncrementalPlanner::GetState(const FSVONLink& aLink)
+{
+	FState* state = myStates.Find(aLink);
+	if (!state)
+	{
+		state = &myStates.Add(aLink);
+		myData->GetLinkPosition(aLink, state->myPosition);
+	}
+	return *state;
+}
+
+FSVONIncrementalPlanner::FKey FSVONIncrementalPlanner::CalculateKey(const FState& aState) const
+{
+	FKey key;
+	const float g = FMath::Min(aState.myG, aState.myRhs);
+	if (g < FLT_MAX)
+	{
+		key.myPrimary = g + mySettings.myEstimateWeight * myPathFinder.HeuristicScore(aState.myPosition, myGoalPosition, myGoal) + myKeyModifier;
+		key.mySecondary = g;
+	}
+	return key;
+}
+
+void FSVONIncrementalPlanner::UpdateState(const FSVONLink& aLink)
+{
+	FState& state = GetState(aLink);
+
+	if (state.myG == state.myRhs)
+	{
+		state.myIsOpen = false;
+		return;
+	}
+
+	const FKey key = CalculateKey(state);
+	if (state.myIsOpen && state.myKey == key)
+		return;
+
+	state.myKey = key;
+	state.myIsOpen = true;
+	myOpen.HeapPush({key, aLink});
+}
+
+void FSVONIncrementalPlanner::UpdateRhs(const FSVONLink& aLink)
+{
+	FState& state = GetState(aLink);
+
+	if (aLink == myStart)
+	{
+		state.myRhs = 0.f;
+		state.myParent.SetInvalid();
+		return;
+	}
+
+	float bestRhs = FLT_MAX;
+	FSVONLink bestParent;
+
+	// Only links we've already reached can have a finite g, so there's no need to add states for the others
+	myData->ForEachLinkNeighbour(aLink, [&](const FSVONLink& aNeighbour) {
+		const FState* neighbourState = aNeighbour.IsValid() ? myStates.Find(aNeighbour) : nullptr;
+		if (!neighbourState || neighbourState->myG == FLT_MAX)
+			return;
+
+		const float rhs = neighbourState->myG + myPathFinder.GetCost(neighbourState->myPosition, state.myPosition, aLink);
+		if (rhs < bestRhs)
+		{
+			bestRhs = rhs;
+			bestParent = aNeighbour;
+		}
+	});
+
+	state.myRhs = bestRhs;
+	state.myParent = bestParent;
+}
+
+bool FSVONIncrementalPlanner::PeekOpen(FOpenEntry& oEntry)
+{
+	while (myOpen.Num() > 0)
+	{
+		const FOpenEntry& top = myOpen.HeapTop();
+		const FState* state = myStates.Find(top.myLink);
+		if (state && state->myIsOpen && state->myKey == top.myKey)
+		{
+			oEntry = top;
+			return true;
+		}
+		myOpen.HeapPopDiscard();
+	}
+	return false;
+}
+
+bool FSVONIncrementalPlanner::ComputePath(const FThreadSafeBool* aCancelFlag)
+{
+	TArray<FSVONLink, TInlineAllocator<64>> neighbours;
+	FOpenEntry top;
+
+	while (PeekOpen(top))
+	{
+		// Done once nothing open could improve the goal, and the goal itself is settled
+		const FState* goalState = myStates.Find(myGoal);
+		if (goalState && !(top.myKey < CalculateKey(*goalState)) && goalState->myRhs <= goalState->myG)
+			break;
+
+		// Stopping between expansions leaves every link either consistent or still queued, so the next call just carries on
+		if (aCancelFlag && myNumIterations % CancelCheckInterval == 0 && *aCancelFlag)
+			return false;
+
+		myOpen.HeapPopDiscard();
+
+		// Keys queued before the goal moved are lower bounds, so requeue with the real key rather than expand early
+		FState& state = myStates.FindChecked(top.myLink);
+		const FKey key = CalculateKey(state);
+		if (top.myKey < key)
+		{
+			state.myKey = key;
+			myOpen.HeapPush({key, top.myLink});
+			continue;
+		}
+
+		state.myIsOpen = false;
+		myNumIterations++;
+
+		neighbours.Reset();
+		myData->ForEachLinkNeighbour(top.myLink, [&neighbours](const FSVONLink& aNeighbour) {
+			if (aNeighbour.IsValid())
+			{
+				neighbours.Add(aNeighbour);
+			}
+		});
+
+		if (state.myG > state.myRhs)
+		{
+			state.myG = state.myRhs;
+
+			// Copied out, as adding neighbour states can move this one
+			const float g = state.myG;
+			const FVector position = state.myPosition;
+
+			for (const FSVONLink& neighbour : neighbours)
+			{
+				if (neighbour == myStart)
+					continue;
+
+				FState& neighbourState = GetState(neighbour);
+				const float rhs = g + myPathFinder.GetCost(position, neighbourState.myPosition, neighbour);
+				if (rhs < neighbourState.myRhs)
+				{
+					neighbourState.myRhs = rhs;
+					neighbourState.myParent = top.myLink;
+					UpdateState(neighbour);
+				}
+			}
+		}
+		else
+		{
+			// Underconsistent, so everything that took its path through this link has to find another way in
+			state.myG = FLT_MAX;
+
+			for (const FSVONLink& neighbour : neighbours)
+			{
+				const FState* neighbourState = myStates.Find(neighbour);
+				if (neighbourState && neighbourState->myParent == top.myLink)
+				{
+					UpdateRhs(neighbour);
+					UpdateState(neighbour);
+				}
+			}
+
+			UpdateState(top.myLink);
+		}
+	}
+
+	const FState* goalState = myStates.Find(myGoal);
+	return goalState && goalState->myRhs < FLT_MAX;
+}
@@ -23,6 +23,11 @@ bool USVONMediator::GetLinkFromPosition(const FVector& aPosition, const ASVONVol
 	// The local position of the point in volume space
 	FVector localPos = aPosition - zOrigin;
 
+	// Calculate the XYZ coordinates on layer 0, the morton code on any layer above is just this code shifted down
+	FIntVector voxel;
+	GetVolumeXYZ(aPosition, aVolume, 0, voxel);
+	const uint64 layerZeroCode = FSVONMorton::Encode(voxel.X, voxel.Y, voxel.Z);
+
 	int layerIndex = aVolume->GetMyNumLayers() - 1;
 	int32 nodeIndex = 0;
 	while (layerIndex >= 0 && layerIndex < aVolume->GetMyNumLayers())
@@ -30,17 +35,9 @@ bool USVONMediator::GetLinkFromPosition(const FVector& aPosition, const ASVONVol
 		// Get the layer and voxel size
 
 		const TArray<FSVONNode>& layer = aVolume->GetLayer(layerIndex);
-		// Calculate the XYZ coordinates
-
-		FIntVector voxel;
-		GetVolumeXYZ(aPosition, aVolume, layerIndex, voxel);
-		uint32 x, y, z;
-		x = voxel.X;
-		y = voxel.Y;
-		z = voxel.Z;
 
 		// Get the morton code we want for this layer
-		uint64 code = libmorton::morton3D_64_encode(x, y, z);
+		uint64 code = layerZeroCode >> (layerIndex * 3);
 
 		for (int32 j = nodeIndex; j < layer.Num(); j++)
 		{
@@ -80,7 +77,7 @@ bool USVONMediator::GetLinkFromPosition(const FVector& aPosition, const ASVONVol
 					oLink.myLayerIndex = 0; // Layer 0 (leaf)
 					oLink.myNodeIndex = j;	// This index
 
-					uint64 leafIndex = libmorton::morton3D_64_encode(coord.X, coord.Y, coord.Z); // This morton code is our key into the 64-bit leaf node
+					uint64 leafIndex = FSVONMorton::Encode(coord.X, coord.Y, coord.Z); // This morton code is our key into the 64-bit leaf node
 
 					if (leaf.GetNode(leafIndex))
 						return false; // This voxel is blocked, oops!
@@ -126,3 +123,105 @@ void USVONMediator::GetVolumeXYZ(const FVector& aPosition, const ASVONVolume* aV
 	oXYZ.Y = FMath::FloorToInt((localPos.Y / voxelSize));
 	oXYZ.Z = FMath::FloorToInt((localPos.Z / voxelSize));
 }
+
+bool USVONMediator::Raycast(const FVector& aStart, const FVector& aEnd, const ASVONVolume* aVolume, FVector& oHitPosition)
+{
+	if (!aVolume)
+		return false;
+
+	return Raycast(aStart, aEnd, *aVolume->GetData(), oHitPosition);
+}
+
+bool USVONMediator::Raycast(const FVector& aStart, const FVector& aEnd, const FSVONData& aData, FVector& oHitPosition)
+{
+	if (aData.GetNumLayers() == 0)
+		return false;
+
+	// Work in leaf voxel units, with the volume's minimum corner at zero
+	const float leafVoxelSize = aData.GetVoxelSize(0) * 0.25f;
+	const FVector zOrigin = aData.GetOrigin() - aData.GetExtent();
+	const FVector start = (aStart - zOrigin) / leafVoxelSize;
+	const FVector direction = (aEnd - zOrigin) / leafVoxelSize - start;
+	const int32 gridSize = 4 << (aData.GetNumLayers() - 1);
+
+	// Clip the segment to the volume
+	float tEnter = 0.f;
+	float tLeave = 1.f;
+	for (int32 axis = 0; axis < 3; axis++)
+	{
+		if (direction[axis] == 0.f)
+		{
+			if (start[axis] < 0.f || start[axis] >= gridSize)
+				return false;
+			continue;
+		}
+
+		float t0 = -start[axis] / direction[axis];
+		float t1 = (gridSize - start[axis]) / direction[axis];
+		if (t0 > t1)
+			Swap(t0, t1);
+
+		tEnter = FMath::Max(tEnter, t0);
+		tLeave = FMath::Min(tLeave, t1);
+	}
+
+	if (tEnter > tLeave)
+		return false;
+
+	float t = tEnter;
+	const FVector entry = start + direction * t;
+	FIntVector voxel(FMath::Clamp(FMath::FloorToInt(entry.X), 0, gridSize - 1), FMath::Clamp(FMath::FloorToInt(entry.Y), 0, gridSize - 1), FMath::Clamp(FMath::FloorToInt(entry.Z), 0, gridSize - 1));
+
+	while (true)
+	{
+		uint32 emptySize = 0;
+		if (aData.IsLeafVoxelBlocked(voxel.X, voxel.Y, voxel.Z, emptySize))
+		{
+			oHitPosition = zOrigin + (start + direction * t) * leafVoxelSize;
+			return true;
+		}
+
+		// The voxel is inside an empty node of emptySize leaf voxels, aligned to its size. Skip straight to where we leave it
+		const int32 cellSize = static_cast<int32>(emptySize);
+		FIntVector cellMin;
+		float tAxis[3];
+		float tExit = FLT_MAX;
+
+		for (int32 axis = 0; axis < 3; axis++)
+		{
+			cellMin[axis] = voxel[axis] & ~(cellSize - 1);
+
+			if (direction[axis] > 0.f)
+				tAxis[axis] = (cellMin[axis] + cellSize - start[axis]) / direction[axis];
+			else if (direction[axis] < 0.f)
+				tAxis[axis] = (cellMin[axis] - start[axis]) / direction[axis];
+			else
+				tAxis[axis] = FLT_MAX;
+
+			tExit = FMath::Min(tExit, tAxis[axis]);
+		}
+
+		// The segment ends inside this node
+		if (tExit >= tLeave)
+			return false;
+
+		t = tExit;
+		const FVector position = start + direction * t;
+
+		// Step out across every face we leave through at once, and find where we are on the others
+		for (int32 axis = 0; axis < 3; axis++)
+		{
+			if (tAxis[axis] <= tExit)
+			{
+				voxel[axis] = direction[axis] > 0.f ? cellMin[axis] + cellSize : cellMin[axis] - 1;
+			}
+			else
+			{
+				voxel[axis] = FMath::Clamp(FMath::FloorToInt(position[axis]), cellMin[axis], cellMin[axis] + cellSize - 1);
+			}
+
+			if (voxel[axis] < 0 || voxel[axis] >= gridSize)
+				return false;
+		}
+	}
+}
@@ -0,0 +1,107 @@
+#include "UESVON/Public/SVONMorton.h"
+
+#if SVON_RUNTIME_BMI2
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SVON_TARGET_BMI2
+#else
+#include <cpuid.h>
+#define SVON_TARGET_BMI2 __attribute__((target("bmi2")))
+#endif
+
+namespace
+{
+uint64 EncodeDefault(uint32 aX, uint32 aY, uint32 aZ)
+{
+	return libmorton::morton3D_64_encode(aX, aY, aZ);
+}
+
+void DecodeDefault(uint64 aCode, uint32& oX, uint32& oY, uint32& oZ)
+{
+	uint_fast32_t x, y, z;
+	libmorton::morton3D_64_decode(aCode, x, y, z);
+	oX = x;
+	oY = y;
+	oZ = z;
+}
+
+SVON_TARGET_BMI2 uint64 EncodeBMI2(uint32 aX, uint32 aY, uint32 aZ)
+{
+	return _pdep_u64(aX, FSVONMorton::GetAxisMask(0)) | _pdep_u64(aY, FSVONMorton::GetAxisMask(1)) | _pdep_u64(aZ, FSVONMorton::GetAxisMask(2));
+}
+
+SVON_TARGET_BMI2 void DecodeBMI2(uint64 aCode, uint32& oX, uint32& oY, uint32& oZ)
+{
+	oX = static_cast<uint32>(_pext_u64(aCode, FSVONMorton::GetAxisMask(0)));
+	oY = static_cast<uint32>(_pext_u64(aCode, FSVONMorton::GetAxisMask(1)));
+	oZ = static_cast<uint32>(_pext_u64(aCode, FSVONMorton::GetAxisMask(2)));
+}
+
+void GetCPUID(uint32 aLeaf, uint32 aSubLeaf, uint32 oRegisters[4])
+{
+#if defined(_MSC_VER)
+	int registers[4];
+	__cpuidex(registers, aLeaf, aSubLeaf);
+	FMemory::Memcpy(oRegisters, registers, sizeof(registers));
+#else
+	__cpuid_count(aLeaf, aSubLeaf, oRegisters[0], oRegisters[1], oRegisters[2], oRegisters[3]);
+#endif
+}
+
+bool HasFastBMI2()
+{
+	uint32 registers[4];
+	GetCPUID(0, 0, registers);
+	const uint32 maxLeaf = registers[0];
+	const bool isAMD = registers[1] == 0x68747541; // "Auth"enticAMD
+
+	if (maxLeaf < 7)
+		return false;
+
+	// BMI2 is bit 8 of EBX in leaf 7
+	GetCPUID(7, 0, registers);
+	if ((registers[1] & (1 << 8)) == 0)
+		return false;
+
+	// AMD before Zen 3 (family 19h) implements pdep/pext in microcode, where they're slower than the lookup tables
+	if (isAMD)
+	{
+		GetCPUID(1, 0, registers);
+		uint32 family = (registers[0] >> 8) & 0xF;
+		if (family == 0xF)
+		{
+			family += (registers[0] >> 20) & 0xFF;
+		}
+		return family >= 0x19;
+	}
+
+	return true;
+}
+} // namespace
+
+uint64 (*FSVONMorton::EncodeFunction)(uint32, uint32, uint32) = &EncodeDefault;
+void (*FSVONMorton::DecodeFunction)(uint64, uint32&, uint32&, uint32&) = &DecodeDefault;
+#endif
+
+const TCHAR* FSVONMorton::KernelName = TEXT("Default");
+
+void FSVONMorton::SelectKernel()
+{
+#if SVON_COMPILED_BMI2
+	KernelName = TEXT("BMI2 (compile time)");
+#else
+	KernelName = TEXT("Lookup table");
+#endif
+
+#if SVON_RUNTIME_BMI2
+	EncodeFunction = &EncodeDefault;
+	DecodeFunction = &DecodeDefault;
+	if (HasFastBMI2())
+	{
+		EncodeFunction = &EncodeBMI2;
+		DecodeFunction = &DecodeBMI2;
+		KernelName = TEXT("BMI2");
+	}
+#endif
+}
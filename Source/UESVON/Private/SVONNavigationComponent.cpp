@@ -5,10 +5,11 @@
 #include "DrawDebugHelpers.h"
 #include "SVONMediator.h"
 #include "Kismet/GameplayStatics.h"
-#include "UESVON/Public/SVONFindPathTask.h"
 #include "UESVON/Public/SVONLink.h"
 #include "UESVON/Public/SVONNavigationPath.h"
 #include "UESVON/Public/SVONPathFinder.h"
+#include "UESVON/Public/SVONPathQuery.h"
+#include "UESVON/Public/SVONPathScheduler.h"
 #include "UESVON/Public/SVONVolume.h"
 
 // Sets default values for this component's properties
@@ -20,6 +21,7 @@ USVONNavigationComponent::USVONNavigationComponent(const FObjectInitializer& Obj
 	LastLocation = FSVONLink(0, 0, 0);
 
 	SVONPath = MakeShareable<FSVONNavigationPath>(new FSVONNavigationPath());
+	IncrementalPlanner = MakeShared<FSVONIncrementalPlanner, ESPMode::ThreadSafe>();
 }
 
 bool USVONNavigationComponent::HasNavData() const
@@ -95,7 +97,7 @@ FSVONLink USVONNavigationComponent::GetNavPosition(FVector& aPosition) const
 	return navLink;
 }
 
-bool USVONNavigationComponent::FindPathAsync(const FVector& aStartPosition, const FVector& aTargetPosition, FThreadSafeBool& aCompleteFlag, FSVONNavPathSharedPtr* oNavPath)
+FSVONPathQuerySharedPtr USVONNavigationComponent::FindPathAsync(const FVector& aStartPosition, const FVector& aTargetPosition, bool aUseIncrementalPlanner)
 {
 #if WITH_EDITOR
 	UE_LOG(UESVON, Log, TEXT("Finding path from %s and %s"), *aStartPosition.ToString(), *aTargetPosition.ToString());
@@ -110,7 +112,7 @@ bool USVONNavigationComponent::FindPathAsync(const FVector& aStartPosition, cons
 #if WITH_EDITOR
 			UE_LOG(UESVON, Error, TEXT("Path finder failed to find start nav link. Is your pawn blocking the channel you've selected to generate the nav data with?"));
 #endif
-			return false;
+			return nullptr;
 		}
 
 		if (!USVONMediator::GetLinkFromPosition(aTargetPosition, CurrentNavVolume, targetNavLink))
@@ -118,20 +120,32 @@ bool USVONNavigationComponent::FindPathAsync(const FVector& aStartPosition, cons
 #if WITH_EDITOR
 			UE_LOG(UESVON, Error, TEXT("Path finder failed to find target nav link"));
 #endif
-			return false;
+			return nullptr;
 		}
 
-		FSVONPathFinderSettings settings;
-		settings.myUseUnitCost = UseUnitCost;
-		settings.myUnitCost = UnitCost;
-		settings.myEstimateWeight = EstimateWeight;
-		settings.myNodeSizeCompensation = NodeSizeCompensation;
-		settings.myPathCostType = PathCostType;
-		settings.mySmoothingIterations = SmoothingIterations;
-
-		(new FAutoDeleteAsyncTask<FSVONFindPathTask>(CurrentNavVolume, settings, GetWorld(), startNavLink, targetNavLink, aStartPosition, aTargetPosition, oNavPath, aCompleteFlag))->StartBackgroundTask();
-
-		return true;
+		USVONPathScheduler* scheduler = GetWorld() ? GetWorld()->GetSubsystem<USVONPathScheduler>() : nullptr;
+		if (!scheduler)
+			return nullptr;
+
+		FSVONPathQuerySharedPtr query = MakeShared<FSVONPathQuery, ESPMode::ThreadSafe>();
+
+		FSVONPathRequest request;
+		request.myData = CurrentNavVolume->GetData();
+		request.mySettings = GetPathFinderSettings();
+		request.myStart = startNavLink;
+		request.myTarget = targetNavLink;
+		request.myStartPos = aStartPosition;
+		request.myTargetPos = aTargetPosition;
+		request.myPlanner = aUseIncrementalPlanner ? IncrementalPlanner : nullptr;
+		request.myQuery = query;
+		request.myOwner = this;
+		request.myPriority = PathRequestPriority;
+		request.myIsVisible = IsPawnVisible();
+
+		// Queued behind everyone else rather than all hitting the thread pool at once
+		scheduler->RequestPath(request);
+
+		return query;
 	}
 	else
 	{
@@ -139,7 +153,7 @@ bool USVONNavigationComponent::FindPathAsync(const FVector& aStartPosition, cons
 		UE_LOG(UESVON, Error, TEXT("Pawn is not inside an SVON volume, or nav data has not been generated"));
 #endif
 	}
-	return false;
+	return nullptr;
 }
 
 bool USVONNavigationComponent::FindPathImmediate(const FVector& aStartPosition, const FVector& aTargetPosition, FSVONNavPathSharedPtr* oNavPath)
@@ -181,13 +195,7 @@ bool USVONNavigationComponent::FindPathImmediate(const FVector& aStartPosition,
 
 		path->ResetForRepath();
 
-		FSVONPathFinderSettings settings;
-		settings.myUseUnitCost = UseUnitCost;
-		settings.myUnitCost = UnitCost;
-		settings.myEstimateWeight = EstimateWeight;
-		settings.myNodeSizeCompensation = NodeSizeCompensation;
-		settings.myPathCostType = PathCostType;
-		settings.mySmoothingIterations = SmoothingIterations;
+		FSVONPathFinderSettings settings = GetPathFinderSettings();
 
 		FSVONPathFinder pathFinder(CurrentNavVolume, settings);
 
@@ -207,6 +215,62 @@ bool USVONNavigationComponent::FindPathImmediate(const FVector& aStartPosition,
 	return false;
 }
 
+bool USVONNavigationComponent::FindPathIncremental(const FVector& aStartPosition, const FVector& aTargetPosition, FSVONNavPathSharedPtr* oNavPath)
+{
+	FSVONLink startNavLink;
+	FSVONLink targetNavLink;
+	if (!HasNavData())
+	{
+#if WITH_EDITOR
+		UE_LOG(UESVON, Error, TEXT("Pawn is not inside an SVON volume, or nav data has not been generated"));
+#endif
+		return false;
+	}
+
+	if (!USVONMediator::GetLinkFromPosition(aStartPosition, CurrentNavVolume, startNavLink) || !USVONMediator::GetLinkFromPosition(aTargetPosition, CurrentNavVolume, targetNavLink))
+	{
+#if WITH_EDITOR
+		UE_LOG(UESVON, Error, TEXT("Incremental planner failed to find start or target nav link"));
+#endif
+		return false;
+	}
+
+	if (!oNavPath || !oNavPath->IsValid())
+		return false;
+
+	FSVONNavigationPath* path = oNavPath->Get();
+	path->ResetForRepath();
+
+	const bool result = IncrementalPlanner->FindPath(CurrentNavVolume->GetData(), GetPathFinderSettings(), startNavLink, targetNavLink, aStartPosition, aTargetPosition, oNavPath);
+
+	path->SetIsReady(result);
+
+	return result;
+}
+
+void USVONNavigationComponent::ResetIncrementalPlanner()
+{
+	// A worker may still be using the old one, so start a new one rather than clearing it under the worker
+	IncrementalPlanner = MakeShared<FSVONIncrementalPlanner, ESPMode::ThreadSafe>();
+}
+
+FSVONPathFinderSettings USVONNavigationComponent::GetPathFinderSettings() const
+{
+	FSVONPathFinderSettings settings;
+	settings.myUseUnitCost = UseUnitCost;
+	settings.myUnitCost = UnitCost;
+	settings.myEstimateWeight = EstimateWeight;
+	settings.myNodeSizeCompensation = NodeSizeCompensation;
+	settings.myPathCostType = PathCostType;
+	settings.mySearchType = PathSearchType;
+	settings.mySmoothingIterations = SmoothingIterations;
+	settings.myUseStringPulling = UseStringPulling;
+	settings.myUseHierarchicalSearch = UseHierarchicalSearch;
+	settings.myHierarchicalLayer = HierarchicalLayer;
+	settings.myReportHierarchicalQuality = ReportHierarchicalQuality;
+	return settings;
+}
+
 void USVONNavigationComponent::FindPathImmediate(const FVector& aStartPosition, const FVector& aTargetPosition, TArray<FVector>& OutPathPoints)
 {
 	FindPathImmediate(aStartPosition, aTargetPosition, &SVONPath);
@@ -227,7 +291,7 @@ void USVONNavigationComponent::DebugLocalPosition()
 		{
 			FIntVector pos;
 			USVONMediator::GetVolumeXYZ(GetPawnPosition(), CurrentNavVolume, i, pos);
-			uint64 code = libmorton::morton3D_64_encode(pos.X, pos.Y, pos.Z);
+			uint64 code = FSVONMorton::Encode(pos.X, pos.Y, pos.Z);
 			FString codeString = FString::FromInt(code);
 			DrawDebugString(GetWorld(), GetPawnPosition() + FVector(0.f, 0.f, i * 50.0f), pos.ToString() + " - " + codeString, NULL, FColor::White, 0.01f);
 		}
@@ -248,3 +312,11 @@ FVector USVONNavigationComponent::GetPawnPosition() const
 
 	return result;
 }
+
+bool USVONNavigationComponent::IsPawnVisible() const
+{
+	AController* controller = Cast<AController>(GetOwner());
+	APawn* pawn = controller ? controller->GetPawn() : nullptr;
+
+	return pawn && pawn->WasRecentlyRendered(0.25f);
+}
@@ -11,7 +11,8 @@ void FSVONNavigationPath::AddPoint(const FSVONPathPoint& aPoint)
 
 void FSVONNavigationPath::ResetForRepath()
 {
-	myPoints.Empty();
+	// Keep the allocation, the next path is likely to be a similar length
+	myPoints.Reset();
 }
 
 void FSVONNavigationPath::DebugDraw(UWorld* aWorld, ASVONVolume* aVolume)
@@ -0,0 +1,100 @@
+#include "UESVON/Public/SVONOpenSet.h"
+
+void FSVONOpenSet::Reset(int32 aNumIds)
+{
+	myHeap.Reset();
+
+	if (myHeapIndices.Num() < aNumIds)
+	{
+		myHeapIndices.SetNumZeroed(aNumIds);
+	}
+
+	// Slots stamped with an older generation read as not in the set. On wrap round, clear them so no stale stamp can match
+	if (++myGeneration == 0)
+	{
+		FMemory::Memzero(myHeapIndices.GetData(), myHeapIndices.Num() * sizeof(FHeapSlot));
+		myGeneration = 1;
+	}
+}
+
+void FSVONOpenSet::Push(int32 aId, const FSVONLink& aLink, float aScore)
+{
+	if (Contains(aId))
+	{
+		const int32 index = myHeapIndices[aId].myIndex;
+		const bool isLower = aScore < myHeap[index].myScore;
+		myHeap[index].myScore = aScore;
+
+		if (isLower)
+			SiftUp(index);
+		else
+			SiftDown(index);
+		return;
+	}
+
+	const int32 index = myHeap.Add({aLink, aId, aScore});
+	SiftUp(index);
+}
+
+FSVONLink FSVONOpenSet::Pop()
+{
+	const FSVONLink result = myHeap[0].myLink;
+	myHeapIndices[myHeap[0].myId].myIndex = INDEX_NONE;
+
+	// Move the last entry to the top, and let it sink back down
+	const FEntry last = myHeap.Pop(false);
+	if (myHeap.Num() > 0)
+	{
+		SetEntry(0, last);
+		SiftDown(0);
+	}
+
+	return result;
+}
+
+void FSVONOpenSet::SiftUp(int32 aIndex)
+{
+	const FEntry entry = myHeap[aIndex];
+
+	while (aIndex > 0)
+	{
+		const int32 parentIndex = (aIndex - 1) / 2;
+		if (myHeap[parentIndex].myScore <= entry.myScore)
+			break;
+
+		SetEntry(aIndex, myHeap[parentIndex]);
+		aIndex = parentIndex;
+	}
+
+	SetEntry(aIndex, entry);
+}
+
+void FSVONOpenSet::SiftDown(int32 aIndex)
+{
+	const FEntry entry = myHeap[aIndex];
+
+	while (true)
+	{
+		int32 childIndex = aIndex * 2 + 1;
+		if (childIndex >= myHeap.Num())
+			break;
+
+		// Pick the lower scoring child
+		if (childIndex + 1 < myHeap.Num() && myHeap[childIndex + 1].myScore < myHeap[childIndex].myScore)
+			childIndex++;
+
+		if (entry.myScore <= myHeap[childIndex].myScore)
+			break;
+
+		SetEntry(aIndex, myHeap[childIndex]);
+		aIndex = childIndex;
+	}
+
+	SetEntry(aIndex, entry);
+}
+
+void FSVONOpenSet::SetEntry(int32 aIndex, const FEntry& aEntry)
+{
+	myHeap[aIndex] = aEntry;
+	myHeapIndices[aEntry.myId] = {myGeneration, aIndex};
+}
@@ -1,101 +1,359 @@
 #include "UESVON/Public/SVONPathFinder.h"
 #include "UESVON/Public/SVONLink.h"
+#include "UESVON/Public/SVONMediator.h"
 #include "UESVON/Public/SVONNode.h"
 #include "UESVON/Public/SVONVolume.h"
 #include "UESVON.h"
 #include "SVONNavigationPath.h"
 
+FThreadSafeCounter FSVONPathFinder::ourNumHierarchicalSearches;
+FThreadSafeCounter FSVONPathFinder::ourNumHierarchicalFallbacks;
+
+FSVONPathFinder::FSVONPathFinder(ASVONVolume* aVolume, FSVONPathFinderSettings& aSettings)
+	: FSVONPathFinder(aVolume->GetData(), aSettings)
+{
+}
+
+FSVONPathFinder::FSVONPathFinder(const FSVONDataConstPtr& aData, FSVONPathFinderSettings& aSettings)
+	: myData(aData)
+	, mySettings(aSettings)
+	, myContext(&FSVONPathFinderContext::Get())
+{
+}
+
 int FSVONPathFinder::FindPath(const FSVONLink& aStart, const FSVONLink& aGoal, const FVector& aStartPos, const FVector& aTargetPos, FSVONNavPathSharedPtr* oPath)
 {
-	myOpenSet.Empty();
-	myClosedSet.Empty();
-	myCameFrom.Empty();
-	myFScore.Empty();
-	myGScore.Empty();
+#if WITH_EDITOR
+	const double startTime = FPlatformTime::Seconds();
+#endif
+
+	myNumIterations = 0;
+
+	const bool usedHierarchical = mySettings.myUseHierarchicalSearch && SearchHierarchical(aStart, aGoal);
+
+#if WITH_EDITOR
+	if (mySettings.myUseHierarchicalSearch && mySettings.myReportHierarchicalQuality && !IsCancelled())
+	{
+		const int32 numSearches = ourNumHierarchicalSearches.Increment();
+		const int32 numFallbacks = usedHierarchical ? ourNumHierarchicalFallbacks.GetValue() : ourNumHierarchicalFallbacks.Increment();
+		UE_LOG(UESVON, Display, TEXT("Hierarchical search fell back to a full search on %i of %i queries"), numFallbacks, numSearches);
+	}
+#endif
+
+	// Without the hierarchical search, or if it couldn't find a way through its corridor, search everything
+	if (!usedHierarchical && (IsCancelled() || !Search(aStart, aGoal, mySettings.mySearchType, [this](const FSVONLink& aLink, auto&& aVisitor) { myData->ForEachLinkNeighbour(aLink, aVisitor); })))
+	{
+#if WITH_EDITOR
+		UE_LOG(UESVON, Display, TEXT("Pathfinding failed, iterations : %i, time : %f ms"), myNumIterations, (FPlatformTime::Seconds() - startTime) * 1000.0);
+#endif
+		return 0;
+	}
+
+	BuildPath(myStart, myGoal, aStartPos, aTargetPos, [this](const FSVONLink& aLink) { return GetScratch(aLink).myCameFrom; }, oPath);
+
+#if WITH_EDITOR
+	UE_LOG(UESVON, Display, TEXT("Pathfinding complete, iterations : %i, time : %f ms"), myNumIterations, (FPlatformTime::Seconds() - startTime) * 1000.0);
+
+	if (usedHierarchical && mySettings.myReportHierarchicalQuality)
+	{
+		const float hierarchicalCost = GetScratch(myGoal).myGScore;
+		if (Search(aStart, aGoal, mySettings.mySearchType, [this](const FSVONLink& aLink, auto&& aVisitor) { myData->ForEachLinkNeighbour(aLink, aVisitor); }))
+		{
+			const float flatCost = GetScratch(myGoal).myGScore;
+			UE_LOG(UESVON, Display, TEXT("Hierarchical path cost : %f, full search cost : %f, ratio : %f"), hierarchicalCost, flatCost, flatCost > 0.f ? hierarchicalCost / flatCost : 1.f);
+		}
+	}
+#endif
+
+	return 1;
+}
+
+template <typename NeighbourFunctionType>
+bool FSVONPathFinder::Search(const FSVONLink& aStart, const FSVONLink& aGoal, ESVONPathSearchType aSearchType, NeighbourFunctionType&& aForEachNeighbour)
+{
+	if (aSearchType == ESVONPathSearchType::Bidirectional)
+		return SearchBidirectional(aStart, aGoal, aForEachNeighbour);
+
+	const bool anyAngle = aSearchType == ESVONPathSearchType::LazyThetaStar;
+
+	myContext->Reset(myData->GetNumLinkIds());
 	myCurrent = FSVONLink();
 	myGoal = aGoal;
 	myStart = aStart;
+	myData->GetLinkPosition(myGoal, myGoalPosition);
 
-	myOpenSet.Add(aStart);
-	myCameFrom.Add(aStart, aStart);
-	myGScore.Add(aStart, 0);
-	myFScore.Add(aStart, HeuristicScore(aStart, myGoal)); // Distance to target
+	FVector startPosition;
+	myData->GetLinkPosition(aStart, startPosition);
 
-	int numIterations = 0;
+	FSVONNodeScratch& startScratch = GetScratch(aStart);
+	startScratch.myCameFrom = aStart;
+	startScratch.myGScore = 0;
+	myContext->myOpenSet.Push(myData->GetLinkId(aStart), aStart, HeuristicScore(startPosition, myGoalPosition, myGoal)); // Distance to target
 
-	while (myOpenSet.Num() > 0)
+	while (!myContext->myOpenSet.IsEmpty())
 	{
-		float lowestScore = FLT_MAX;
-		for (FSVONLink& link : myOpenSet)
-		{
-			if (!myFScore.Contains(link) || myFScore[link] < lowestScore)
-			{
-				lowestScore = myFScore[link];
-				myCurrent = link;
-			}
-		}
+		if (myNumIterations % CancelCheckInterval == 0 && IsCancelled())
+			return false;
 
-		myOpenSet.Remove(myCurrent);
-		myClosedSet.Add(myCurrent);
+		// The open set is a heap, so the lowest f-score is always on top
+		myCurrent = myContext->myOpenSet.Pop();
+		myData->GetLinkPosition(myCurrent, myCurrentPosition);
 
-		if (myCurrent == myGoal)
+		if (anyAngle)
 		{
-			BuildPath(myCameFrom, myCurrent, aStartPos, aTargetPos, oPath);
-#if WITH_EDITOR
-			UE_LOG(UESVON, Display, TEXT("Pathfinding complete, iterations : %i"), numIterations);
-#endif
-			return 1;
+			SetVertex(aForEachNeighbour);
 		}
 
-		const FSVONNode& currentNode = Volume->GetNode(myCurrent);
+		FSVONNodeScratch& currentScratch = GetScratch(myCurrent);
+		currentScratch.myIsClosed = true;
 
-		TArray<FSVONLink> neighbours;
+		if (myCurrent == myGoal)
+			return true;
 
-		if (myCurrent.GetLayerIndex() == 0 && currentNode.myFirstChild.IsValid())
+		myExpandFrom = anyAngle ? currentScratch.myCameFrom : myCurrent;
+		if (myExpandFrom == myCurrent)
 		{
-			Volume->GetLeafNeighbours(myCurrent, neighbours);
+			myExpandFromPosition = myCurrentPosition;
 		}
 		else
 		{
-			Volume->GetNeighbours(myCurrent, neighbours);
+			myData->GetLinkPosition(myExpandFrom, myExpandFromPosition);
 		}
 
-		for (const FSVONLink& neighbour : neighbours)
+		aForEachNeighbour(myCurrent, [this](const FSVONLink& aNeighbour) { ProcessLink(aNeighbour); });
+
+		myNumIterations++;
+	}
+
+	return false;
+}
+
+template <typename NeighbourFunctionType>
+bool FSVONPathFinder::SearchBidirectional(const FSVONLink& aStart, const FSVONLink& aGoal, NeighbourFunctionType&& aForEachNeighbour)
+{
+	myContext->Reset(myData->GetNumLinkIds(), true);
+	myCurrent = FSVONLink();
+	myGoal = aGoal;
+	myStart = aStart;
+	myData->GetLinkPosition(myGoal, myGoalPosition);
+
+	FVector startPosition;
+	myData->GetLinkPosition(aStart, startPosition);
+
+	FSVONOpenSet& forwardOpenSet = myContext->myOpenSet;
+	FSVONOpenSet& backwardOpenSet = myContext->myBackwardOpenSet;
+
+	FSVONNodeScratch& startScratch = GetScratch(aStart);
+	startScratch.myCameFrom = aStart;
+	startScratch.myGScore = 0;
+	forwardOpenSet.Push(myData->GetLinkId(aStart), aStart, HeuristicScore(startPosition, myGoalPosition, myGoal));
+
+	FSVONNodeScratch& goalScratch = myContext->GetBackwardScratch(myData->GetLinkId(aGoal));
+	goalScratch.myCameFrom = aGoal;
+	goalScratch.myGScore = 0;
+	backwardOpenSet.Push(myData->GetLinkId(aGoal), aGoal, HeuristicScore(myGoalPosition, startPosition, myStart));
+
+	// The cheapest complete path found so far, and the link where its two halves meet
+	float bestCost = aStart == aGoal ? 0.f : FLT_MAX;
+	FSVONLink meetingLink = aStart == aGoal ? aStart : FSVONLink::GetInvalidLink();
+
+	while (!forwardOpenSet.IsEmpty() && !backwardOpenSet.IsEmpty())
+	{
+		if (myNumIterations % CancelCheckInterval == 0 && IsCancelled())
+			return false;
+
+		// Anything better would have to go through open links on both sides, so would cost at least the lowest f-score of either
+		if (FMath::Max(forwardOpenSet.PeekScore(), backwardOpenSet.PeekScore()) >= bestCost)
+			break;
+
+		// Grow whichever frontier is smaller, so they meet roughly in the middle
+		const bool isForward = forwardOpenSet.Num() <= backwardOpenSet.Num();
+		FSVONOpenSet& openSet = isForward ? forwardOpenSet : backwardOpenSet;
+		const FSVONLink& target = isForward ? myGoal : myStart;
+		const FVector& targetPosition = isForward ? myGoalPosition : startPosition;
+
+		myCurrent = openSet.Pop();
+		myData->GetLinkPosition(myCurrent, myCurrentPosition);
+
+		const int32 currentId = myData->GetLinkId(myCurrent);
+		FSVONNodeScratch& currentScratch = isForward ? myContext->GetScratch(currentId) : myContext->GetBackwardScratch(currentId);
+		currentScratch.myIsClosed = true;
+
+		aForEachNeighbour(myCurrent, [&](const FSVONLink& aNeighbour) {
+			if (!aNeighbour.IsValid())
+				return;
+
+			const int32 neighbourId = myData->GetLinkId(aNeighbour);
+			FSVONNodeScratch& neighbourScratch = isForward ? myContext->GetScratch(neighbourId) : myContext->GetBackwardScratch(neighbourId);
+
+			if (neighbourScratch.myIsClosed)
+				return;
+
+			FVector neighbourPosition;
+			myData->GetLinkPosition(aNeighbour, neighbourPosition);
+
+			// Costs are always taken in the direction of travel from start to goal, so both halves measure a path the same way
+			const float cost = isForward ? GetCost(myCurrentPosition, neighbourPosition, aNeighbour) : GetCost(neighbourPosition, myCurrentPosition, myCurrent);
+			const float t_gScore = currentScratch.myGScore + cost;
+
+			if (t_gScore >= neighbourScratch.myGScore)
+				return;
+
+			neighbourScratch.myCameFrom = myCurrent;
+			neighbourScratch.myGScore = t_gScore;
+			openSet.Push(neighbourId, aNeighbour, t_gScore + (mySettings.myEstimateWeight * HeuristicScore(neighbourPosition, targetPosition, target)));
+
+			// If the other side has reached this link too, there's a complete path through it
+			const FSVONNodeScratch& otherScratch = isForward ? myContext->GetBackwardScratch(neighbourId) : myContext->GetScratch(neighbourId);
+			if (otherScratch.myGScore < FLT_MAX && t_gScore + otherScratch.myGScore < bestCost)
+			{
+				bestCost = t_gScore + otherScratch.myGScore;
+				meetingLink = aNeighbour;
+			}
+		});
+
+		myNumIterations++;
+	}
+
+	if (!meetingLink.IsValid())
+		return false;
+
+	// Point the forward scratch along the backward half, so BuildPath can walk the whole path from the goal
+	for (FSVONLink link = meetingLink; !(link == myGoal);)
+	{
+		const FSVONLink next = myContext->GetBackwardScratch(myData->GetLinkId(link)).myCameFrom;
+		GetScratch(next).myCameFrom = link;
+		link = next;
+	}
+
+	GetScratch(myGoal).myGScore = bestCost;
+
+	return true;
+}
+
+template <typename NeighbourFunctionType>
+void FSVONPathFinder::SetVertex(NeighbourFunctionType&& aForEachNeighbour)
+{
+	FSVONNodeScratch& currentScratch = GetScratch(myCurrent);
+	const FSVONLink parent = currentScratch.myCameFrom;
+
+	// The start is its own parent
+	if (parent == myCurrent)
+		return;
+
+	FVector parentPosition;
+	myData->GetLinkPosition(parent, parentPosition);
+
+	if (HasLineOfSight(parentPosition, myCurrentPosition))
+		return;
+
+	float bestScore = FLT_MAX;
+	FSVONLink bestLink;
+
+	aForEachNeighbour(myCurrent, [&](const FSVONLink& aNeighbour) {
+		const FSVONNodeScratch& neighbourScratch = GetScratch(aNeighbour);
+		if (!neighbourScratch.myIsClosed)
+			return;
+
+		FVector neighbourPosition;
+		myData->GetLinkPosition(aNeighbour, neighbourPosition);
+
+		const float score = neighbourScratch.myGScore + GetCost(neighbourPosition, myCurrentPosition, myCurrent);
+		if (score < bestScore)
 		{
-			ProcessLink(neighbour);
+			bestScore = score;
+			bestLink = aNeighbour;
 		}
+	});
 
-		numIterations++;
+	// We were reached from a closed link, so there should always be one. If the links aren't symmetric, keep the parent we had
+	if (bestLink.IsValid())
+	{
+		currentScratch.myCameFrom = bestLink;
+		currentScratch.myGScore = bestScore;
 	}
-#if WITH_EDITOR
-	UE_LOG(UESVON, Display, TEXT("Pathfinding failed, iterations : %i"), numIterations);
-#endif
-	return 0;
 }
 
-float FSVONPathFinder::HeuristicScore(const FSVONLink& aStart, const FSVONLink& aTarget)
+bool FSVONPathFinder::HasLineOfSight(const FVector& aStartPos, const FVector& aTargetPos) const
+{
+	FVector hitPosition;
+	return !USVONMediator::Raycast(aStartPos, aTargetPos, *myData, hitPosition);
+}
+
+bool FSVONPathFinder::SearchHierarchical(const FSVONLink& aStart, const FSVONLink& aGoal)
+{
+	// The top layer has no neighbour links, and layer 0 is no coarser than the full search
+	if (myData->GetNumLayers() < 3)
+		return false;
+
+	const uint8 coarseLayer = FMath::Clamp<int32>(mySettings.myHierarchicalLayer, 1, myData->GetNumLayers() - 2);
+
+	const FSVONLink coarseGoal = GetAncestor(aGoal, coarseLayer);
+
+	// Plan over whole nodes on the coarse layer. Solid nodes are walls, anything partly open is assumed passable
+	if (!Search(GetAncestor(aStart, coarseLayer), coarseGoal, ESVONPathSearchType::AStar, [this, coarseLayer](const FSVONLink& aLink, auto&& aVisitor) { myData->ForEachNodeNeighbour(aLink, coarseLayer, aVisitor); }))
+		return false;
+
+	// Mark every coarse node on the route, and its open face neighbours, so the refine has room to get round anything inside
+	// a route node. The next search resets the scratch, so this has to happen first
+	myContext->ResetCorridor(myData->GetNumLinkIds());
+	for (FSVONLink link = coarseGoal;;)
+	{
+		myContext->AddToCorridor(myData->GetLinkId(link));
+		myData->ForEachNodeNeighbour(link, coarseLayer, [this](const FSVONLink& aNeighbour) { myContext->AddToCorridor(myData->GetLinkId(aNeighbour)); });
+
+		const FSVONLink cameFrom = GetScratch(link).myCameFrom;
+		if (!cameFrom.IsValid() || cameFrom == link)
+			break;
+
+		link = cameFrom;
+	}
+
+	// Then refine at full resolution, only expanding into links that sit inside the corridor
+	return Search(aStart, aGoal, mySettings.mySearchType, [this, coarseLayer](const FSVONLink& aLink, auto&& aVisitor) {
+		myData->ForEachLinkNeighbour(aLink, [&](const FSVONLink& aNeighbour) {
+			if (myContext->IsInCorridor(myData->GetLinkId(GetAncestor(aNeighbour, coarseLayer))))
+			{
+				aVisitor(aNeighbour);
+			}
+		});
+	});
+}
+
+FSVONLink FSVONPathFinder::GetAncestor(FSVONLink aLink, uint8 aLayer) const
+{
+	while (aLink.GetLayerIndex() < aLayer)
+	{
+		const FSVONLink& parent = myData->GetNode(aLink).myParent;
+		if (!parent.IsValid())
+			break;
+
+		aLink = parent;
+	}
+
+	return aLink;
+}
+
+float FSVONPathFinder::HeuristicScore(const FVector& aStartPos, const FVector& aTargetPos, const FSVONLink& aTarget) const
 {
 	/* Just using manhattan distance for now */
 	float score;
 
-	FVector startPos, endPos;
-	Volume->GetLinkPosition(aStart, startPos);
-	Volume->GetLinkPosition(aTarget, endPos);
 	switch (mySettings.myPathCostType)
 	{
-	case ESVONPathCostType::Manhattan: score = FMath::Abs(endPos.X - startPos.X) + FMath::Abs(endPos.Y - startPos.Y) + FMath::Abs(endPos.Z - startPos.Z);
+	case ESVONPathCostType::Manhattan: score = FMath::Abs(aTargetPos.X - aStartPos.X) + FMath::Abs(aTargetPos.Y - aStartPos.Y) + FMath::Abs(aTargetPos.Z - aStartPos.Z);
 		break;
 	case ESVONPathCostType::Euclidean:
-	default: score = (startPos - endPos).Size();
+	default: score = (aStartPos - aTargetPos).Size();
 		break;
 	}
 
-	score *= (1.0f - (static_cast<float>(aTarget.GetLayerIndex()) / static_cast<float>(Volume->GetMyNumLayers())) * mySettings.myNodeSizeCompensation);
+	score *= (1.0f - (static_cast<float>(aTarget.GetLayerIndex()) / static_cast<float>(myData->GetNumLayers())) * mySettings.myNodeSizeCompensation);
 
 	return score;
 }
 
-float FSVONPathFinder::GetCost(const FSVONLink& aStart, const FSVONLink& aTarget)
+float FSVONPathFinder::GetCost(const FVector& aStartPos, const FVector& aTargetPos, const FSVONLink& aTarget) const
 {
 	float cost;
 
@@ -106,13 +364,10 @@ float FSVONPathFinder::GetCost(const FSVONLink& aStart, const FSVONLink& aTarget
 	}
 	else
 	{
-		FVector startPos(0.f), endPos(0.f);
-		Volume->GetLinkPosition(aStart, startPos);
-		Volume->GetLinkPosition(aTarget, endPos);
-		cost = (startPos - endPos).Size();
+		cost = (aStartPos - aTargetPos).Size();
 	}
 
-	cost *= (1.0f - (static_cast<float>(aTarget.GetLayerIndex()) / static_cast<float>(Volume->GetMyNumLayers())) * mySettings.myNodeSizeCompensation);
+	cost *= (1.0f - (static_cast<float>(aTarget.GetLayerIndex()) / static_cast<float>(myData->GetNumLayers())) * mySettings.myNodeSizeCompensation);
 
 	return cost;
 }
@@ -121,51 +376,59 @@ void FSVONPathFinder::ProcessLink(const FSVONLink& aNeighbour)
 {
 	if (aNeighbour.IsValid())
 	{
-		if (myClosedSet.Contains(aNeighbour))
+		const int32 neighbourId = myData->GetLinkId(aNeighbour);
+		FSVONNodeScratch& neighbourScratch = GetScratch(aNeighbour);
+
+		if (neighbourScratch.myIsClosed)
 			return;
 
-		if (!myOpenSet.Contains(aNeighbour))
-		{
-			myOpenSet.Add(aNeighbour);
+		FVector neighbourPosition;
+		myData->GetLinkPosition(aNeighbour, neighbourPosition);
 
-			if (mySettings.myDebugOpenNodes)
-			{
-				FVector pos;
-				Volume->GetLinkPosition(aNeighbour, pos);
-				mySettings.myDebugPoints.Add(pos);
-			}
+		if (mySettings.myDebugOpenNodes && !myContext->myOpenSet.Contains(neighbourId))
+		{
+			mySettings.myDebugPoints.Add(neighbourPosition);
 		}
 
-		float t_gScore = FLT_MAX;
-		if (myGScore.Contains(myCurrent))
-			t_gScore = myGScore[myCurrent] + GetCost(myCurrent, aNeighbour);
-		else
-			myGScore.Add(myCurrent, FLT_MAX);
+		// The link we expand from was popped from the open set, so it always has a g-score by now
+		const float t_gScore = GetScratch(myExpandFrom).myGScore + GetCost(myExpandFromPosition, neighbourPosition, aNeighbour);
 
-		if (t_gScore >= (myGScore.Contains(aNeighbour) ? myGScore[aNeighbour] : FLT_MAX))
+		if (t_gScore >= neighbourScratch.myGScore)
 			return;
 
-		myCameFrom.Add(aNeighbour, myCurrent);
-		myGScore.Add(aNeighbour, t_gScore);
-		myFScore.Add(aNeighbour, myGScore[aNeighbour] + (mySettings.myEstimateWeight * HeuristicScore(aNeighbour, myGoal)));
+		neighbourScratch.myCameFrom = myExpandFrom;
+		neighbourScratch.myGScore = t_gScore;
+		// Adds the neighbour to the open set, or moves it up the heap if it's already there
+		myContext->myOpenSet.Push(neighbourId, aNeighbour, t_gScore + (mySettings.myEstimateWeight * HeuristicScore(neighbourPosition, myGoalPosition, myGoal)));
 	}
 }
 
-void FSVONPathFinder::BuildPath(TMap<FSVONLink, FSVONLink>& aCameFrom, FSVONLink aCurrent, const FVector& aStartPos, const FVector& aTargetPos, FSVONNavPathSharedPtr* oPath)
+FSVONNodeScratch& FSVONPathFinder::GetScratch(const FSVONLink& aLink)
+{
+	return myContext->GetScratch(myData->GetLinkId(aLink));
+}
+
+void FSVONPathFinder::BuildPath(const FSVONLink& aStart, FSVONLink aCurrent, const FVector& aStartPos, const FVector& aTargetPos, TFunctionRef<FSVONLink(const FSVONLink&)> aGetCameFrom, FSVONNavPathSharedPtr* oPath)
 {
 	FSVONPathPoint pos;
 
-	TArray<FSVONPathPoint> points;
+	TArray<FSVONPathPoint>& points = myContext->myPoints;
+	points.Reset();
 
 	if (!oPath || !oPath->IsValid())
 		return;
 
-	while (aCameFrom.Contains(aCurrent) && !(aCurrent == aCameFrom[aCurrent]))
+	// No path can visit more links than there are, which guards against a loop if the parents are ever inconsistent
+	for (int32 i = 0; i < myData->GetNumLinkIds(); i++)
 	{
-		aCurrent = aCameFrom[aCurrent];
-		Volume->GetLinkPosition(aCurrent, pos.myPosition);
+		const FSVONLink cameFrom = aGetCameFrom(aCurrent);
+		if (!cameFrom.IsValid() || cameFrom == aCurrent)
+			break;
+
+		aCurrent = cameFrom;
+		myData->GetLinkPosition(aCurrent, pos.myPosition);
 		points.Add(pos);
-		const FSVONNode& node = Volume->GetNode(aCurrent);
+		const FSVONNode& node = myData->GetNode(aCurrent);
 		// This is rank. I really should sort the layers out
 		if (aCurrent.GetLayerIndex() == 0)
 		{
@@ -191,7 +454,18 @@ void FSVONPathFinder::BuildPath(TMap<FSVONLink, FSVONLink>& aCameFrom, FSVONLink
 			points.Emplace();
 
 		points[0].myPosition = aTargetPos;
-		points.Emplace(aStartPos, myStart.GetLayerIndex());
+		points.Emplace(aStartPos, aStart.GetLayerIndex());
+	}
+
+	// Post process while the points are still in our buffer. Neither cares that they run from the target back to the start
+	if (mySettings.myUseStringPulling)
+	{
+		StringPull(points);
+	}
+
+	if (mySettings.mySmoothingIterations > 0)
+	{
+		Smooth_Chaikin(points, mySettings.mySmoothingIterations);
 	}
 
 	for (int i = points.Num() - 1; i >= 0; i--)
@@ -199,3 +473,61 @@ void FSVONPathFinder::BuildPath(TMap<FSVONLink, FSVONLink>& aCameFrom, FSVONLink
 		oPath->Get()->GetPathPoints().Add(points[i]);
 	}
 }
+
+void FSVONPathFinder::StringPull(TArray<FSVONPathPoint>& somePoints) const
+{
+	if (somePoints.Num() < 3)
+		return;
+
+	// Keep a point only when the last kept point can't see the one after it. Kept points never overtake the read position, so this works in place
+	int32 numKept = 1;
+	FVector anchor = somePoints[0].myPosition;
+
+	for (int32 i = 2; i < somePoints.Num(); i++)
+	{
+		if (!HasLineOfSight(anchor, somePoints[i].myPosition))
+		{
+			anchor = somePoints[i - 1].myPosition;
+			somePoints[numKept++] = somePoints[i - 1];
+		}
+	}
+
+	somePoints[numKept++] = somePoints.Last();
+	somePoints.SetNum(numKept, false);
+}
+
+void FSVONPathFinder::Smooth_Chaikin(TArray<FSVONPathPoint>& somePoints, int aNumIterations)
+{
+	TArray<FSVONPathPoint>& smoothed = myContext->mySmoothedPoints;
+
+	for (int i = 0; i < aNumIterations && somePoints.Num() > 2; i++)
+	{
+		const int32 last = somePoints.Num() - 1;
+
+		smoothed.Reset();
+		smoothed.Add(somePoints[0]);
+		smoothed.Emplace(FMath::Lerp(somePoints[0].myPosition, somePoints[1].myPosition, 0.25f), somePoints[0].myLayer);
+
+		// Everything but the cut across each corner lies on a segment we already had, so that cut is all that needs checking.
+		// Corners are usually there because something blocks the shortcut, and where the cut would clip it, we keep the corner
+		for (int32 j = 1; j < last; j++)
+		{
+			const FSVONPathPoint& corner = somePoints[j];
+			const FVector cutStart = FMath::Lerp(somePoints[j - 1].myPosition, corner.myPosition, 0.75f);
+			const FVector cutEnd = FMath::Lerp(corner.myPosition, somePoints[j + 1].myPosition, 0.25f);
+
+			smoothed.Emplace(cutStart, corner.myLayer);
+			if (!HasLineOfSight(cutStart, cutEnd))
+			{
+				smoothed.Add(corner);
+			}
+			smoothed.Emplace(cutEnd, corner.myLayer);
+		}
+
+		smoothed.Emplace(FMath::Lerp(somePoints[last - 1].myPosition, somePoints[last].myPosition, 0.75f), somePoints[last].myLayer);
+		smoothed.Add(somePoints[last]);
+
+		// Both buffers keep their allocations, so repeated iterations and later queries don't allocate
+		Swap(somePoints, smoothed);
+	}
+}
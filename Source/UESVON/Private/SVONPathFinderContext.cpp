@@ -0,0 +1,46 @@
+#include "UESVON/Public/SVONPathFinderContext.h"
+
+void FSVONPathFinderContext::Reset(int32 aNumIds, bool aBidirectional)
+{
+	myOpenSet.Reset(aNumIds);
+	myPoints.Reset();
+
+	// Only ever grow, so alternating between volumes of different sizes doesn't reallocate
+	if (myScratch.Num() < aNumIds)
+	{
+		myScratch.SetNumZeroed(aNumIds);
+	}
+
+	// The backward buffers share our generation, so they only need to exist on threads that have run a bidirectional search
+	if (aBidirectional)
+	{
+		myBackwardOpenSet.Reset(aNumIds);
+
+		if (myBackwardScratch.Num() < aNumIds)
+		{
+			myBackwardScratch.SetNumZeroed(aNumIds);
+		}
+	}
+
+	// Generation 0 is never used, so zeroed entries always read as unvisited. On wrap round, clear everything
+	if (++myGeneration == 0)
+	{
+		FMemory::Memzero(myScratch.GetData(), myScratch.Num() * sizeof(FSVONNodeScratch));
+		FMemory::Memzero(myBackwardScratch.GetData(), myBackwardScratch.Num() * sizeof(FSVONNodeScratch));
+		myGeneration = 1;
+	}
+}
+
+void FSVONPathFinderContext::ResetCorridor(int32 aNumIds)
+{
+	if (myCorridorStamps.Num() < aNumIds)
+	{
+		myCorridorStamps.SetNumZeroed(aNumIds);
+	}
+
+	if (++myCorridorGeneration == 0)
+	{
+		FMemory::Memzero(myCorridorStamps.GetData(), myCorridorStamps.Num() * sizeof(uint32));
+		myCorridorGeneration = 1;
+	}
+}
@@ -0,0 +1,172 @@
+#include "UESVON/Public/SVONPathScheduler.h"
+#include "UESVON/Public/SVONFindPathTask.h"
+#include "UESVON.h"
+
+void USVONPathScheduler::Deinitialize()
+{
+	for (const FSVONPathRequest& pending : myPending)
+	{
+		Abandon(pending.myQuery);
+	}
+
+	// The workers push to our finished queue, so they have to be done before we go away. Cancelled, they won't be long
+	for (const FInFlightRequest& inFlight : myInFlight)
+	{
+		inFlight.myQuery->Cancel();
+	}
+
+	for (const FInFlightRequest& inFlight : myInFlight)
+	{
+		inFlight.myQuery->myFinishedEvent->Wait();
+		inFlight.myQuery->myIsComplete = true;
+	}
+
+	myInFlight.Empty();
+	myFinished.Empty();
+	myPending.Empty();
+
+	Super::Deinitialize();
+}
+
+void USVONPathScheduler::RequestPath(const FSVONPathRequest& aRequest)
+{
+	const auto hasPrecedence = [](const FSVONPathRequest& aA, const FSVONPathRequest& aB) { return HasPrecedence(aA, aB); };
+
+	// A worker still on the owner's last request is wasting its time
+	for (const FInFlightRequest& inFlight : myInFlight)
+	{
+		if (inFlight.myOwner == aRequest.myOwner && inFlight.myQuery != aRequest.myQuery)
+		{
+			inFlight.myQuery->Cancel();
+		}
+	}
+
+	// Only the latest request from an owner matters, but it keeps its place in the queue
+	for (FSVONPathRequest& pending : myPending)
+	{
+		if (pending.myOwner == aRequest.myOwner)
+		{
+			const uint64 sequence = pending.mySequence;
+			const int32 priority = FMath::Max(pending.myPriority, aRequest.myPriority);
+			const bool isVisible = pending.myIsVisible || aRequest.myIsVisible;
+
+			if (pending.myQuery != aRequest.myQuery)
+			{
+				Abandon(pending.myQuery);
+			}
+
+			pending = aRequest;
+			pending.mySequence = sequence;
+			pending.myPriority = priority;
+			pending.myIsVisible = isVisible;
+
+			myPending.Heapify(hasPrecedence);
+			return;
+		}
+	}
+
+	FSVONPathRequest request = aRequest;
+	request.mySequence = myNextSequence++;
+	myPending.HeapPush(request, hasPrecedence);
+}
+
+void USVONPathScheduler::Tick(float DeltaTime)
+{
+	const double endTime = FPlatformTime::Seconds() + FrameBudgetMs / 1000.0;
+
+	// Results first, so finished work isn't held back by new requests
+	if (CompleteRequests(endTime))
+	{
+		DispatchRequests(endTime);
+	}
+}
+
+bool USVONPathScheduler::IsTickable() const
+{
+	return !IsTemplate() && (myPending.Num() > 0 || myInFlight.Num() > 0);
+}
+
+TStatId USVONPathScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USVONPathScheduler, STATGROUP_Tickables);
+}
+
+bool USVONPathScheduler::HasPrecedence(const FSVONPathRequest& aRequest, const FSVONPathRequest& aOther)
+{
+	if (aRequest.myPriority != aOther.myPriority)
+		return aRequest.myPriority > aOther.myPriority;
+
+	if (aRequest.myIsVisible != aOther.myIsVisible)
+		return aRequest.myIsVisible;
+
+	return aRequest.mySequence < aOther.mySequence;
+}
+
+void USVONPathScheduler::Abandon(const FSVONPathQuerySharedPtr& aQuery)
+{
+	aQuery->Cancel();
+	aQuery->myIsSuccess = false;
+	aQuery->myIsComplete = true;
+}
+
+bool USVONPathScheduler::IsPlannerInFlight(const FSVONIncrementalPlannerSharedPtr& aPlanner) const
+{
+	return aPlanner.IsValid() && myInFlight.ContainsByPredicate([&aPlanner](const FInFlightRequest& aInFlight) { return aInFlight.myPlanner == aPlanner; });
+}
+
+bool USVONPathScheduler::CompleteRequests(double aEndTime)
+{
+	FSVONPathQuerySharedPtr query;
+	while (myFinished.Peek(query))
+	{
+		if (FPlatformTime::Seconds() > aEndTime)
+			return false;
+
+		myFinished.Pop();
+
+		myInFlight.RemoveAllSwap([&query](const FInFlightRequest& aInFlight) { return aInFlight.myQuery == query; }, false);
+
+		query->myIsComplete = true;
+		if (!query->IsCancelled())
+		{
+			query->OnComplete.ExecuteIfBound(query);
+		}
+	}
+	return true;
+}
+
+void USVONPathScheduler::DispatchRequests(double aEndTime)
+{
+	const auto hasPrecedence = [](const FSVONPathRequest& aA, const FSVONPathRequest& aB) { return HasPrecedence(aA, aB); };
+
+	// Requests whose planner is still busy with an earlier one wait for the next frame. It was cancelled, so won't be long
+	TArray<FSVONPathRequest, TInlineAllocator<8>> deferred;
+
+	while (myPending.Num() > 0 && myInFlight.Num() < MaxConcurrentTasks && FPlatformTime::Seconds() <= aEndTime)
+	{
+		FSVONPathRequest request;
+		myPending.HeapPop(request, hasPrecedence, false);
+
+		// Cancelled while it was queued, so it never needs a worker
+		if (request.myQuery->IsCancelled())
+		{
+			Abandon(request.myQuery);
+			continue;
+		}
+
+		if (IsPlannerInFlight(request.myPlanner))
+		{
+			deferred.Add(request);
+			continue;
+		}
+
+		myInFlight.Add({request.myQuery, request.myOwner, request.myPlanner});
+
+		(new FAutoDeleteAsyncTask<FSVONFindPathTask>(request.myData, request.mySettings, request.myStart, request.myTarget, request.myStartPos, request.myTargetPos, request.myPlanner, request.myQuery, myFinished))->StartBackgroundTask();
+	}
+
+	for (const FSVONPathRequest& request : deferred)
+	{
+		myPending.HeapPush(request, hasPrecedence);
+	}
+}
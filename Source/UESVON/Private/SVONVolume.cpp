@@ -1,8 +1,10 @@
 #include "UESVON/Public/SVONVolume.h"
 #include "UESVON.h"
+#include "Async/ParallelFor.h"
 #include "DrawDebugHelpers.h"
 #include "Components/BrushComponent.h"
 #include "Components/LineBatchComponent.h"
+#include "Misc/ScopeLock.h"
 
 ASVONVolume::ASVONVolume(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -12,6 +14,8 @@ ASVONVolume::ASVONVolume(const FObjectInitializer& ObjectInitializer)
 	, myIsReadyForNavigation(false)
 
 {
+	myData = MakeShared<FSVONData, ESPMode::ThreadSafe>();
+
 	GetBrushComponent()->Mobility = EComponentMobility::Static;
 
 	BrushColor = FColor(255, 255, 255, 255);
@@ -24,6 +28,36 @@ ASVONVolume::ASVONVolume(const FObjectInitializer& ObjectInitializer)
 
 // Regenerates the Sparse Voxel Octree Navmesh
 bool ASVONVolume::Generate()
+{
+	if (IsGenerating())
+	{
+#if WITH_EDITOR
+		UE_LOG(UESVON, Warning, TEXT("Already generating in the background, ignoring generate request"));
+#endif
+		return false;
+	}
+
+	BeginGeneration();
+	BuildData();
+	FinishGeneration();
+
+	return true;
+}
+
+bool ASVONVolume::GenerateAsync()
+{
+	if (IsGenerating())
+		return false;
+
+	BeginGeneration();
+
+	myGenerationTask = MakeUnique<FAsyncTask<FSVONGenerateTask>>(this);
+	myGenerationTask->StartBackgroundTask();
+
+	return true;
+}
+
+void ASVONVolume::BeginGeneration()
 {
 #if WITH_EDITOR
 	// Needed for debug rendering
@@ -44,43 +78,79 @@ bool ASVONVolume::Generate()
 	FlushPersistentDebugLines(GetWorld());
 
 	// Setup timing
-	double startTime = FPlatformTime::Seconds();
+	myGenerationStartTime = FPlatformTime::Seconds();
 
 #endif // WITH_EDITOR
 
 	UpdateBounds();
+	myIsGenerationCancelled = false;
 
-	// Clear data (for now)
+	// Build into fresh data, queries carry on reading the published data until we're done
 	myBlockedIndices.Empty();
-	myData.myLayers.Empty();
+	myBuildData = MakeShared<FSVONData, ESPMode::ThreadSafe>();
+	myBuildData->myOrigin = myOrigin;
+	myBuildData->myExtent = myExtent;
 
 	myNumLayers = myVoxelPower + 1;
+}
+
+// Everything from here to FinishGeneration only touches the build data, so it's safe on a worker thread.
+// Returns false if background generation was cancelled part way through
+bool ASVONVolume::BuildData()
+{
+	// One step for the first pass, one per layer rasterized and linked, and one for the position cache
+	const float numSteps = myNumLayers * 2 + 1;
+	int32 step = 0;
+
+	if (myIsGenerationCancelled)
+		return false;
 
 	// Rasterize at Layer 1
 	FirstPassRasterize();
+	ReportGenerationProgress(++step / numSteps);
 
-	// Allocate the leaf node data
-	myData.myLeafNodes.Empty();
-	myData.myLeafNodes.AddDefaulted(myBlockedIndices[0].Num() * 8 * 0.25f);
+	// Leaf node data is allocated once layer 0 is known, in RasterizeLeafNodes
+	myBuildData->myLeafNodes.Empty();
 
 	// Add layers
 	for (int i = 0; i < myNumLayers; i++)
 	{
-		myData.myLayers.Emplace();
+		myBuildData->myLayers.Emplace();
 	}
 
 	// Rasterize layer, bottom up, adding parent/child links
 	for (int i = 0; i < myNumLayers; i++)
 	{
+		if (myIsGenerationCancelled)
+			return false;
+
 		RasterizeLayer(i);
+		ReportGenerationProgress(++step / numSteps);
 	}
 
 	// Now traverse down, adding neighbour links
 	for (int i = myNumLayers - 2; i >= 0; i--)
 	{
+		if (myIsGenerationCancelled)
+			return false;
+
 		BuildNeighbourLinks(i);
+		ReportGenerationProgress(++step / numSteps);
 	}
 
+	if (myIsGenerationCancelled)
+		return false;
+
+	myBuildData->BuildLinkIds();
+	myBuildData->BuildBlockedNodes();
+	BuildPositionCache(*myBuildData);
+	ReportGenerationProgress(1.f);
+
+	return true;
+}
+
+void ASVONVolume::FinishGeneration()
+{
 #if WITH_EDITOR
 
 	double endTime = FPlatformTime::Seconds();
@@ -89,296 +159,240 @@ bool ASVONVolume::Generate()
 
 	for (int i = 0; i < myNumLayers; i++)
 	{
-		totalNodes += myData.myLayers[i].Num();
+		totalNodes += myBuildData->myLayers[i].Num();
 	}
 
 	int32 totalBytes = sizeof(FSVONNode) * totalNodes;
-	totalBytes += sizeof(FSVONLeafNode) * myData.myLeafNodes.Num();
+	totalBytes += sizeof(FSVONLeafNode) * myBuildData->myLeafNodes.Num();
 
-	UE_LOG(UESVON, Display, TEXT("Generation Time : %f"), endTime - startTime);
+	UE_LOG(UESVON, Display, TEXT("Generation Time : %f"), endTime - myGenerationStartTime);
 	UE_LOG(UESVON, Display, TEXT("Total Layers-Nodes : %d-%d"), myNumLayers, totalNodes);
-	UE_LOG(UESVON, Display, TEXT("Total Leaf Nodes : %d"), myData.myLeafNodes.Num());
+	UE_LOG(UESVON, Display, TEXT("Total Leaf Nodes : %d"), myBuildData->myLeafNodes.Num());
 	UE_LOG(UESVON, Display, TEXT("Total Size (bytes): %d"), totalBytes);
 
 #endif
 
-	myNumBytes = myData.GetSize();
+	myNumBytes = myBuildData->GetSize();
 
-	return true;
-}
-
-void ASVONVolume::UpdateBounds()
-{
-	// Get bounds and extent
-	FBox bounds = GetComponentsBoundingBox(true);
-	bounds.GetCenterAndExtents(myOrigin, myExtent);
+	PublishData(myBuildData);
+	myBuildData.Reset();
+	myBlockedIndices.Empty();
 }
 
-void ASVONVolume::ClearData()
+void ASVONVolume::FinishGenerationAsync(bool aSucceeded)
 {
-	myData.Reset();
-	myNumLayers = 0;
-	myNumBytes = 0;
-}
+	// Ended play, or cancelled, since the task finished
+	if (!myGenerationTask.IsValid() || myIsGenerationCancelled)
+		return;
 
-bool ASVONVolume::FirstPassRasterize()
-{
-	// Add the first layer of blocking
-	myBlockedIndices.Emplace();
+	myGenerationTask->EnsureCompletion();
+	myGenerationTask.Reset();
 
-	int32 numNodes = GetNumNodesInLayer(1);
-	for (int32 i = 0; i < numNodes; i++)
+	if (aSucceeded)
 	{
-		FVector position;
-		GetNodePosition(1, i, position);
-		FCollisionQueryParams params;
-		params.bFindInitialOverlaps = true;
-		params.bTraceComplex = false;
-		params.TraceTag = "SVONFirstPassRasterize";
-		if (GetWorld()->OverlapBlockingTestByChannel(position, FQuat::Identity, myCollisionChannel, FCollisionShape::MakeBox(FVector(GetVoxelSize(1) * 0.5f)), params))
-		{
-			myBlockedIndices[0].Add(i);
-		}
+		FinishGeneration();
+		myIsReadyForNavigation = true;
+	}
+	else
+	{
+		myBuildData.Reset();
+		myBlockedIndices.Empty();
 	}
 
-	int layerIndex = 0;
+	OnGenerationCompleted.Broadcast(this, aSucceeded);
+}
 
-	while (myBlockedIndices[layerIndex].Num() > 1)
+// Progress goes out on the game thread, wherever the generation is running
+void ASVONVolume::ReportGenerationProgress(float aProgress)
+{
+	if (IsInGameThread())
 	{
-		// Add a new layer to structure
-		myBlockedIndices.Emplace();
-		// Add any parent morton codes to the new layer
-		for (uint64& code : myBlockedIndices[layerIndex])
-		{
-			myBlockedIndices[layerIndex + 1].Add(code >> 3);
-		}
-		layerIndex++;
+		OnGenerationProgress.Broadcast(this, aProgress);
+		return;
 	}
 
-	return true;
+	myGenerationTask->GetTask().ReportProgress(aProgress);
 }
 
-bool ASVONVolume::GetNodePosition(uint8 aLayer, uint64 aCode, FVector& oPosition) const
+void ASVONVolume::UpdateBounds()
 {
-	const float voxelSize = GetVoxelSize(aLayer);
-	uint_fast32_t x, y, z;
-	libmorton::morton3D_64_decode(aCode, x, y, z);
-	oPosition = myOrigin - myExtent + FVector(x * voxelSize, y * voxelSize, z * voxelSize) + FVector(voxelSize * 0.5f);
-	return true;
+	// Get bounds and extent
+	FBox bounds = GetComponentsBoundingBox(true);
+	bounds.GetCenterAndExtents(myOrigin, myExtent);
 }
 
-// Gets the position of a given link. Returns true if the link is open, false if blocked
-bool ASVONVolume::GetLinkPosition(const FSVONLink& aLink, FVector& oPosition) const
+// The positions depend on the bounds as well as the layers, so this has to happen after the data's bounds are set
+void ASVONVolume::BuildPositionCache(FSVONData& aData)
 {
-	const FSVONNode& node = GetLayer(aLink.GetLayerIndex())[aLink.GetNodeIndex()];
+	aData.ResetPositionCache();
+	myNumPositionCacheBytes = 0;
 
-	GetNodePosition(aLink.GetLayerIndex(), node.myCode, oPosition);
-	// If this is layer 0, and there are valid children
-	if (aLink.GetLayerIndex() == 0 && node.myFirstChild.IsValid())
-	{
-		float voxelSize = GetVoxelSize(0);
-		uint_fast32_t x, y, z;
-		libmorton::morton3D_64_decode(aLink.GetSubnodeIndex(), x, y, z);
-		oPosition += FVector(x * voxelSize * 0.25f, y * voxelSize * 0.25f, z * voxelSize * 0.25f) - FVector(voxelSize * 0.375);
-		const FSVONLeafNode& leafNode = GetLeafNode(node.myFirstChild.myNodeIndex);
-		bool isBlocked = leafNode.GetNode(aLink.GetSubnodeIndex());
-		return !isBlocked;
-	}
-	return true;
-}
+	if (!myUsePositionCache)
+		return;
 
-bool ASVONVolume::GetIndexForCode(uint8 aLayer, uint64 aCode, int32& oIndex) const
-{
-	const TArray<FSVONNode>& layer = GetLayer(aLayer);
+	aData.BuildPositionCache(!myUseParallelRasterization);
+	myNumPositionCacheBytes = aData.GetPositionCacheSize();
 
-	for (int i = 0; i < layer.Num(); i++)
-	{
-		if (layer[i].myCode == aCode)
-		{
-			oIndex = i;
-			return true;
-		}
-	}
+#if WITH_EDITOR
+	UE_LOG(UESVON, Display, TEXT("Position Cache Size (bytes): %d"), myNumPositionCacheBytes);
+#endif
+}
 
-	return false;
+FSVONDataConstPtr ASVONVolume::GetData() const
+{
+	FScopeLock lock(&myDataLock);
+	return myData;
 }
 
-const FSVONNode& ASVONVolume::GetNode(const FSVONLink& aLink) const
+// Readers copy the pointer under the same lock, so they either get the old data or the new, never a torn pointer.
+// The old data is freed when the last query holding it lets go
+void ASVONVolume::PublishData(const FSVONDataPtr& aData)
 {
-	if (aLink.GetLayerIndex() < 14)
-	{
-		return GetLayer(aLink.GetLayerIndex())[aLink.GetNodeIndex()];
-	}
-	else
-	{
-		return GetLayer(myNumLayers - 1)[0];
-	}
+	FScopeLock lock(&myDataLock);
+	myData = aData;
 }
 
-const FSVONLeafNode& ASVONVolume::GetLeafNode(int32 aIndex) const
+void ASVONVolume::ClearData()
 {
-	return myData.myLeafNodes[aIndex];
+	PublishData(MakeShared<FSVONData, ESPMode::ThreadSafe>());
+	myNumLayers = 0;
+	myNumBytes = 0;
+	myNumPositionCacheBytes = 0;
 }
 
-void ASVONVolume::GetLeafNeighbours(const FSVONLink& aLink, TArray<FSVONLink>& oNeighbours) const
+bool ASVONVolume::FirstPassRasterize()
 {
-	uint64 leafIndex = aLink.GetSubnodeIndex();
-	const FSVONNode& node = GetNode(aLink);
-	const FSVONLeafNode& leaf = GetLeafNode(node.myFirstChild.GetNodeIndex());
+	// Add the first layer of blocking
+	myBlockedIndices.Emplace();
 
-	// Get our starting co-ordinates
-	uint_fast32_t x = 0, y = 0, z = 0;
-	libmorton::morton3D_64_decode(leafIndex, x, y, z);
+#if WITH_EDITOR
+	double startTime = FPlatformTime::Seconds();
+#endif
+
+	int32 numNodes = GetNumNodesInLayer(1);
 
-	for (int i = 0; i < 6; i++)
+	if (myRasterizeStrategy == ESVORasterizeStrategy::TopDown)
 	{
-		// Need to switch to signed ints
-		int32 sX = x + USVONStatics::dirs[i].X;
-		int32 sY = y + USVONStatics::dirs[i].Y;
-		int32 sZ = z + USVONStatics::dirs[i].Z;
+		FirstPassRasterizeTopDown();
+	}
+	else if (myUseParallelRasterization)
+	{
+		// Split the morton range into contiguous chunks, each worker writes to its own buffer
+		const int32 numChunks = FMath::Min(FTaskGraphInterface::Get().GetNumWorkerThreads() * 4, numNodes);
+		const int32 chunkSize = FMath::DivideAndRoundUp(numNodes, FMath::Max(numChunks, 1));
 
-		// If the neighbour is in bounds of this leaf node
-		if (sX >= 0 && sX < 4 && sY >= 0 && sY < 4 && sZ >= 0 && sZ < 4)
-		{
-			uint64 thisIndex = libmorton::morton3D_64_encode(sX, sY, sZ);
-			// If this node is blocked, then no link in this direction, continue
-			if (leaf.GetNode(thisIndex))
-			{
-				continue;
-			}
-			else // Otherwise, this is a valid link, add it
+		TArray<TArray<uint64>> chunkBlockedCodes;
+		chunkBlockedCodes.SetNum(numChunks);
+
+		ParallelFor(numChunks, [&](int32 aChunk) {
+			// Cancelled chunks leave their buffer empty, the caller throws the result away
+			if (myIsGenerationCancelled)
+				return;
+
+			const int32 chunkEnd = FMath::Min((aChunk + 1) * chunkSize, numNodes);
+			for (int32 i = aChunk * chunkSize; i < chunkEnd; i++)
 			{
-				oNeighbours.Emplace(0, aLink.GetNodeIndex(), thisIndex);
-				continue;
+				if (IsNodeBlocked(1, i))
+				{
+					chunkBlockedCodes[aChunk].Add(i);
+				}
 			}
+		});
+
+		// Merge in chunk order, so we end up with exactly what the serial path produces
+		for (const TArray<uint64>& chunk : chunkBlockedCodes)
+		{
+			myBlockedIndices[0].Append(chunk);
 		}
-		else // the neighbours is out of bounds, we need to find our neighbour
+	}
+	else
+	{
+		for (int32 i = 0; i < numNodes && !myIsGenerationCancelled; i++)
 		{
-			const FSVONLink& neighbourLink = node.myNeighbours[i];
-			const FSVONNode& neighbourNode = GetNode(neighbourLink);
-
-			// If the neighbour layer 0 has no leaf nodes, just return it
-			if (!neighbourNode.myFirstChild.IsValid())
+			if (IsNodeBlocked(1, i))
 			{
-				oNeighbours.Add(neighbourLink);
-				continue;
+				myBlockedIndices[0].Add(i);
 			}
+		}
+	}
 
-			const FSVONLeafNode& leafNode = GetLeafNode(neighbourNode.myFirstChild.GetNodeIndex());
+#if WITH_EDITOR
+	UE_LOG(UESVON, Display, TEXT("First Pass Rasterize Time (%s, %s) : %f"), myRasterizeStrategy == ESVORasterizeStrategy::TopDown ? TEXT("top down") : TEXT("bottom up"), myUseParallelRasterization ? TEXT("parallel") : TEXT("serial"), FPlatformTime::Seconds() - startTime);
+#endif
 
-			if (leafNode.IsCompletelyBlocked())
-			{
-				// The leaf node is completely blocked, we don't return it
-				continue;
-			}
-			else // Otherwise, we need to find the correct subnode
+	// Add the parent codes of each layer, all the way up to the root. The codes are sorted, so duplicate parents are always adjacent
+	for (int layerIndex = 0; layerIndex < myNumLayers - 2; layerIndex++)
+	{
+		myBlockedIndices.Emplace();
+		const TArray<uint64>& blockedCodes = myBlockedIndices[layerIndex];
+		TArray<uint64>& parentCodes = myBlockedIndices[layerIndex + 1];
+
+		for (const uint64 code : blockedCodes)
+		{
+			if (parentCodes.Num() == 0 || parentCodes.Last() != code >> 3)
 			{
-				if (sX < 0)
-					sX = 3;
-				else if (sX > 3)
-					sX = 0;
-				else if (sY < 0)
-					sY = 3;
-				else if (sY > 3)
-					sY = 0;
-				else if (sZ < 0)
-					sZ = 3;
-				else if (sZ > 3)
-					sZ = 0;
-				//
-				uint64 subNodeCode = libmorton::morton3D_64_encode(sX, sY, sZ);
-
-				// Only return the neighbour if it isn't blocked!
-				if (!leafNode.GetNode(subNodeCode))
-				{
-					oNeighbours.Emplace(0, neighbourNode.myFirstChild.GetNodeIndex(), subNodeCode);
-				}
+				parentCodes.Add(code >> 3);
 			}
 		}
 	}
+
+	return true;
 }
 
-void ASVONVolume::GetNeighbours(const FSVONLink& aLink, TArray<FSVONLink>& oNeighbours) const
+void ASVONVolume::FirstPassRasterizeTopDown()
 {
-	const FSVONNode& node = GetNode(aLink);
-
-	for (int i = 0; i < 6; i++)
+	// Start at the root, and only test the children of nodes that were blocked on the layer above.
+	// A parent's box is exactly the union of its children's boxes, so this finds the same layer 1 codes as testing them all
+	TArray<uint64> candidateCodes;
+	TArray<uint64> nextCandidateCodes;
+	TArray<bool> isCandidateBlocked;
+	candidateCodes.Add(0);
+
+	for (int32 layer = myNumLayers - 1; layer >= 1; layer--)
 	{
-		const FSVONLink& neighbourLink = node.myNeighbours[i];
-
-		if (!neighbourLink.IsValid())
-			continue;
-
-		const FSVONNode& neighbour = GetNode(neighbourLink);
+		isCandidateBlocked.SetNumZeroed(candidateCodes.Num());
 
-		// If the neighbour has no children, it's empty, we just use it
-		if (!neighbour.HasChildren())
-		{
-			oNeighbours.Add(neighbourLink);
-			continue;
-		}
+		ParallelFor(candidateCodes.Num(), [&](int32 aCandidate) {
+			if (myIsGenerationCancelled)
+				return;
 
-		// If the node has children, we need to look down the tree to see which children we want to add to the neighbour set
+			isCandidateBlocked[aCandidate] = IsNodeBlocked(layer, candidateCodes[aCandidate]);
+		}, !myUseParallelRasterization);
 
-		// Start working set, and put the link into it
-		TArray<FSVONLink> workingSet;
-		workingSet.Push(neighbourLink);
+		nextCandidateCodes.Reset();
 
-		while (workingSet.Num() > 0)
+		// Candidates are in morton order, and so are the children we add from them
+		for (int32 i = 0; i < candidateCodes.Num(); i++)
 		{
-			// Pop off the top of the working set
-			FSVONLink thisLink = workingSet.Pop();
-			const FSVONNode& thisNode = GetNode(thisLink);
-
-			// If the node as no children, it's clear, so add to neighbours and continue
-			if (!thisNode.HasChildren())
-			{
-				oNeighbours.Add(neighbourLink);
+			if (!isCandidateBlocked[i])
 				continue;
-			}
 
-			// We know it has children
-
-			if (thisLink.GetLayerIndex() > 0)
+			if (layer == 1)
 			{
-				// If it's above layer 0, we will need to potentially add 4 children using our offsets
-				for (const int32& childIndex : USVONStatics::dirChildOffsets[i])
-				{
-					// Each of the childnodes
-					FSVONLink childLink = thisNode.myFirstChild;
-					childLink.myNodeIndex += childIndex;
-					const FSVONNode& childNode = GetNode(childLink);
-
-					if (childNode.HasChildren()) // If it has children, add them to the working set to keep going down
-					{
-						workingSet.Emplace(childLink);
-					}
-					else // Or just add to the outgoing links
-					{
-						oNeighbours.Emplace(childLink);
-					}
-				}
+				myBlockedIndices[0].Add(candidateCodes[i]);
 			}
 			else
 			{
-				// If this is a leaf layer, then we need to add whichever of the 16 facing leaf nodes aren't blocked
-				for (const int32& leafIndex : USVONStatics::dirLeafChildOffsets[i])
+				for (uint64 childOffset = 0; childOffset < 8; childOffset++)
 				{
-					// Each of the childnodes
-					FSVONLink link = neighbour.myFirstChild;
-					const FSVONLeafNode& leafNode = GetLeafNode(link.myNodeIndex);
-					link.mySubnodeIndex = leafIndex;
-
-					if (!leafNode.GetNode(leafIndex))
-					{
-						oNeighbours.Emplace(link);
-					}
+					nextCandidateCodes.Add((candidateCodes[i] << 3) | childOffset);
 				}
 			}
 		}
+
+		Swap(candidateCodes, nextCandidateCodes);
 	}
 }
 
+bool ASVONVolume::GetNodePosition(uint8 aLayer, uint64 aCode, FVector& oPosition) const
+{
+	const float voxelSize = GetVoxelSize(aLayer);
+	uint32 x, y, z;
+	FSVONMorton::Decode(aCode, x, y, z);
+	oPosition = myOrigin - myExtent + FVector(x * voxelSize, y * voxelSize, z * voxelSize) + FVector(voxelSize * 0.5f);
+	return true;
+}
+
 void ASVONVolume::Serialize(FArchive& Ar)
 {
 	// Serialize the usual UPROPERTIES
@@ -386,10 +400,21 @@ void ASVONVolume::Serialize(FArchive& Ar)
 
 	if (myGenerationStrategy == ESVOGenerationStrategy::UseBaked)
 	{
-		Ar << myData;
+		if (Ar.IsLoading())
+		{
+			FSVONDataPtr data = MakeShared<FSVONData, ESPMode::ThreadSafe>();
+			Ar << *data;
+			data->BuildLinkIds();
+			data->BuildBlockedNodes();
+			PublishData(data);
+		}
+		else
+		{
+			Ar << *myData;
+		}
 
-		myNumLayers = myData.myLayers.Num();
-		myNumBytes = myData.GetSize();
+		myNumLayers = myData->myLayers.Num();
+		myNumBytes = myData->GetSize();
 	}
 }
 
@@ -417,16 +442,42 @@ void ASVONVolume::BeginPlay()
 {
 	if (!myIsReadyForNavigation && myGenerationStrategy == ESVOGenerationStrategy::GenerateOnBeginPlay)
 	{
+		// We become ready for navigation when the task hands the data back
+		if (myGenerateInBackground && GenerateAsync())
+			return;
+
 		Generate();
 	}
 	else
 	{
+		// Nothing can query the baked data until we're ready for navigation, so it's safe to fill in place
 		UpdateBounds();
+		myData->myOrigin = myOrigin;
+		myData->myExtent = myExtent;
+		BuildPositionCache(*myData);
 	}
 
 	myIsReadyForNavigation = true;
 }
 
+void ASVONVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// The task reads the world and writes to us, so it can't outlive either. If it hasn't started, it never will. If it has,
+	// the rasterize passes skip every overlap test left once they see the flag, so it's back within a node or chunk.
+	// Don't let EnsureCompletion do the work itself on this thread
+	if (myGenerationTask.IsValid())
+	{
+		myIsGenerationCancelled = true;
+		myGenerationTask->Cancel();
+		myGenerationTask->EnsureCompletion(false);
+		myGenerationTask.Reset();
+		myBuildData.Reset();
+		myBlockedIndices.Empty();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void ASVONVolume::PostRegisterAllComponents()
 {
 	Super::PostRegisterAllComponents();
@@ -439,19 +490,11 @@ void ASVONVolume::PostUnregisterAllComponents()
 
 void ASVONVolume::BuildNeighbourLinks(uint8 aLayer)
 {
+	TArray<FSVONNode>& layer = myBuildData->GetLayer(aLayer);
 
-	TArray<FSVONNode>& layer = GetLayer(aLayer);
-	uint8 searchLayer = aLayer;
-
-	// For each node
-	for (int32 i = 0; i < layer.Num(); i++)
-	{
-		FSVONNode& node = layer[i];
-		// Get our world co-ordinate
-		uint_fast32_t x, y, z;
-		libmorton::morton3D_64_decode(node.myCode, x, y, z);
-		int32 backtrackIndex = -1;
-		int32 index = i;
+	// Each node only writes its own neighbour links, so we can process the layer in parallel. Debug lines have to be drawn from this thread though
+	ParallelFor(layer.Num(), [&](int32 aNodeIndex) {
+		FSVONNode& node = layer[aNodeIndex];
 		FVector nodePos;
 		GetNodePosition(aLayer, node.myCode, nodePos);
 
@@ -460,11 +503,12 @@ void ASVONVolume::BuildNeighbourLinks(uint8 aLayer)
 		{
 			FSVONLink& linkToUpdate = node.myNeighbours[d];
 
-			backtrackIndex = index;
+			int32 index = aNodeIndex;
+			uint8 searchLayer = aLayer;
 
-			while (!FindLinkInDirection(searchLayer, index, d, linkToUpdate, nodePos) && aLayer < myData.myLayers.Num() - 2)
+			while (!FindLinkInDirection(searchLayer, index, d, linkToUpdate, nodePos) && aLayer < myBuildData->myLayers.Num() - 2)
 			{
-				FSVONLink& parent = GetLayer(searchLayer)[index].myParent;
+				const FSVONLink& parent = myBuildData->GetLayer(searchLayer)[index].myParent;
 				if (parent.IsValid())
 				{
 					index = parent.myNodeIndex;
@@ -473,32 +517,23 @@ void ASVONVolume::BuildNeighbourLinks(uint8 aLayer)
 				else
 				{
 					searchLayer++;
-					GetIndexForCode(searchLayer, node.myCode >> 3, index);
+					myBuildData->GetIndexForCode(searchLayer, node.myCode >> 3, index);
 				}
 			}
-			index = backtrackIndex;
-			searchLayer = aLayer;
 		}
-	}
+	}, !myUseParallelRasterization || myShowNeighbourLinks);
 }
 
-bool ASVONVolume::FindLinkInDirection(uint8 aLayer, const int32 aNodeIndex, uint8 aDir, FSVONLink& oLinkToUpdate, FVector& aStartPosForDebug)
+bool ASVONVolume::FindLinkInDirection(uint8 aLayer, const int32 aNodeIndex, uint8 aDir, FSVONLink& oLinkToUpdate, const FVector& aStartPosForDebug) const
 {
-	int32 maxCoord = GetNumNodesPerSide(aLayer);
-	FSVONNode& node = GetLayer(aLayer)[aNodeIndex];
-	TArray<FSVONNode>& layer = GetLayer(aLayer);
+	const TArray<FSVONNode>& layer = myBuildData->GetLayer(aLayer);
+	const FSVONNode& node = layer[aNodeIndex];
 
-	// Get our world co-ordinate
-	uint_fast32_t x = 0, y = 0, z = 0;
-	libmorton::morton3D_64_decode(node.myCode, x, y, z);
-	int32 sX = x, sY = y, sZ = z;
-	// Add the direction
-	sX += USVONStatics::dirs[aDir].X;
-	sY += USVONStatics::dirs[aDir].Y;
-	sZ += USVONStatics::dirs[aDir].Z;
+	// Get the morton code for the direction
+	uint64 thisCode = 0;
 
-	// If the coords are out of bounds, the link is invalid.
-	if (sX < 0 || sX >= maxCoord || sY < 0 || sY >= maxCoord || sZ < 0 || sZ >= maxCoord)
+	// If the step takes us out of bounds, the link is invalid.
+	if (!FSVONMorton::Step(node.myCode, aDir, myVoxelPower - aLayer, thisCode))
 	{
 		oLinkToUpdate.SetInvalid();
 		if (myShowNeighbourLinks && IsInDebugRange(aStartPosForDebug))
@@ -510,100 +545,167 @@ bool ASVONVolume::FindLinkInDirection(uint8 aLayer, const int32 aNodeIndex, uint
 		}
 		return true;
 	}
-	x = sX;
-	y = sY;
-	z = sZ;
-	// Get the morton code for the direction
-	uint64 thisCode = libmorton::morton3D_64_encode(x, y, z);
-	bool isHigher = thisCode > node.myCode;
-	int32 nodeDelta = (isHigher ? 1 : -1);
 
-	while ((aNodeIndex + nodeDelta) < layer.Num() && aNodeIndex + nodeDelta >= 0)
+	// If there's no node with this code, it's not on this layer
+	int32 neighbourIndex = 0;
+	if (!myBuildData->GetIndexForCode(aLayer, thisCode, neighbourIndex))
+	{
+		return false;
+	}
+
+	const FSVONNode& thisNode = layer[neighbourIndex];
+	// This is a leaf node
+	if (aLayer == 0 && thisNode.HasChildren())
 	{
-		// This is the node we're looking for
-		if (layer[aNodeIndex + nodeDelta].myCode == thisCode)
+		// Set invalid link if the leaf node is completely blocked, no point linking to it
+		if (myBuildData->GetLeafNode(thisNode.myFirstChild.GetNodeIndex()).IsCompletelyBlocked())
 		{
-			const FSVONNode& thisNode = layer[aNodeIndex + nodeDelta];
-			// This is a leaf node
-			if (aLayer == 0 && thisNode.HasChildren())
-			{
-				// Set invalid link if the leaf node is completely blocked, no point linking to it
-				if (GetLeafNode(thisNode.myFirstChild.GetNodeIndex()).IsCompletelyBlocked())
-				{
-					oLinkToUpdate.SetInvalid();
-					return true;
-				}
-			}
-			// Otherwise, use this link
-			oLinkToUpdate.myLayerIndex = aLayer;
-			check(aNodeIndex + nodeDelta < layer.Num());
-			oLinkToUpdate.myNodeIndex = aNodeIndex + nodeDelta;
-			if (myShowNeighbourLinks && IsInDebugRange(aStartPosForDebug))
-			{
-				FVector endPos;
-				GetNodePosition(aLayer, thisCode, endPos);
-				DrawDebugLine(GetWorld(), aStartPosForDebug, endPos, USVONStatics::myLinkColors[aLayer], true, -1.f, 0, .0f);
-			}
+			oLinkToUpdate.SetInvalid();
 			return true;
 		}
-		// If we've passed the code we're looking for, it's not on this layer
-		else if ((isHigher && layer[aNodeIndex + nodeDelta].myCode > thisCode) || (!isHigher && layer[aNodeIndex + nodeDelta].myCode < thisCode))
-		{
-			return false;
-		}
-
-		nodeDelta += (isHigher ? 1 : -1);
 	}
-
-	// I'm not entirely sure if it's valid to reach the end? Hmmm...
-	return false;
+	// Otherwise, use this link
+	oLinkToUpdate.myLayerIndex = aLayer;
+	oLinkToUpdate.myNodeIndex = neighbourIndex;
+	if (myShowNeighbourLinks && IsInDebugRange(aStartPosForDebug))
+	{
+		FVector endPos;
+		GetNodePosition(aLayer, thisCode, endPos);
+		DrawDebugLine(GetWorld(), aStartPosForDebug, endPos, USVONStatics::myLinkColors[aLayer], true, -1.f, 0, .0f);
+	}
+	return true;
 }
 
-void ASVONVolume::RasterizeLeafNode(FVector& aOrigin, int32 aLeafIndex)
+void ASVONVolume::RasterizeLeafNodes()
 {
-	for (int i = 0; i < 64; i++)
+	TArray<FSVONNode>& layer = myBuildData->GetLayer(0);
+	const float voxelSize = GetVoxelSize(0);
+
+	// Every layer 0 node owns the leaf node at its own index, so the leaf storage is allocated exactly once
+	myBuildData->myLeafNodes.Empty(layer.Num());
+	myBuildData->myLeafNodes.AddDefaulted(layer.Num());
+
+	// Find which layer 0 nodes have any blocking, and so need their leaf nodes rasterizing
+	TArray<bool> isNodeBlocked;
+	isNodeBlocked.SetNumZeroed(layer.Num());
+
+	ParallelFor(layer.Num(), [&](int32 aNodeIndex) {
+		if (myIsGenerationCancelled)
+			return;
+
+		FVector position;
+		GetNodePosition(0, layer[aNodeIndex].myCode, position);
+		isNodeBlocked[aNodeIndex] = IsBlocked(position, voxelSize * 0.5f);
+	}, !myUseParallelRasterization);
+
+	TArray<int32> blockedNodes;
+	for (int32 i = 0; i < layer.Num(); i++)
 	{
+		FSVONNode& node = layer[i];
+		if (isNodeBlocked[i])
+		{
+			blockedNodes.Add(i);
+			node.myFirstChild.SetLayerIndex(0);
+			node.myFirstChild.SetNodeIndex(i);
+			node.myFirstChild.SetSubnodeIndex(0);
+		}
+		else
+		{
+			node.myFirstChild.SetInvalid();
+		}
+	}
 
-		uint_fast32_t x, y, z;
-		libmorton::morton3D_64_decode(i, x, y, z);
-		float leafVoxelSize = GetVoxelSize(0) * 0.25f;
-		FVector position = aOrigin + FVector(x * leafVoxelSize, y * leafVoxelSize, z * leafVoxelSize) + FVector(leafVoxelSize * 0.5f);
+	// Each leaf writes only to its own pre-allocated slot
+	ParallelFor(blockedNodes.Num(), [&](int32 aBlockedIndex) {
+		if (myIsGenerationCancelled)
+			return;
 
-		if (aLeafIndex >= myData.myLeafNodes.Num() - 1)
-			myData.myLeafNodes.AddDefaulted(1);
+		const int32 nodeIndex = blockedNodes[aBlockedIndex];
+		FVector nodePos;
+		GetNodePosition(0, layer[nodeIndex].myCode, nodePos);
+		RasterizeLeafNode(nodePos - FVector(voxelSize * 0.5f), myBuildData->myLeafNodes[nodeIndex]);
+	}, !myUseParallelRasterization);
+
+	// Debug drawing has to happen back on this thread
+	if (myShowLeafVoxels || myShowMortonCodes)
+	{
+		const float leafVoxelSize = voxelSize * 0.25f;
 
-		if (IsBlocked(position, leafVoxelSize * 0.5f))
+		for (const int32 nodeIndex : blockedNodes)
 		{
-			myData.myLeafNodes[aLeafIndex].SetNode(i);
+			FVector nodePos;
+			GetNodePosition(0, layer[nodeIndex].myCode, nodePos);
+			const FVector leafOrigin = nodePos - FVector(voxelSize * 0.5f);
+			const FSVONLeafNode& leafNode = myBuildData->myLeafNodes[nodeIndex];
 
-			if (myShowLeafVoxels && IsInDebugRange(position))
-			{
-				DrawDebugBox(GetWorld(), position, FVector(leafVoxelSize * 0.5f), FQuat::Identity, FColor::Red, true, -1.f, 0, .0f);
-			}
-			if (myShowMortonCodes && IsInDebugRange(position))
+			for (int i = 0; i < 64; i++)
 			{
-				DrawDebugString(GetWorld(), position, FString::FromInt(aLeafIndex) + ":" + FString::FromInt(i), nullptr, FColor::Red, -1, false);
+				if (!leafNode.GetNode(i))
+					continue;
+
+				uint32 x, y, z;
+				FSVONMorton::Decode(i, x, y, z);
+				FVector position = leafOrigin + FVector(x * leafVoxelSize, y * leafVoxelSize, z * leafVoxelSize) + FVector(leafVoxelSize * 0.5f);
+
+				if (myShowLeafVoxels && IsInDebugRange(position))
+				{
+					DrawDebugBox(GetWorld(), position, FVector(leafVoxelSize * 0.5f), FQuat::Identity, FColor::Red, true, -1.f, 0, .0f);
+				}
+				if (myShowMortonCodes && IsInDebugRange(position))
+				{
+					DrawDebugString(GetWorld(), position, FString::FromInt(nodeIndex) + ":" + FString::FromInt(i), nullptr, FColor::Red, -1, false);
+				}
 			}
 		}
 	}
 }
 
-// Check for blocking...using this cached set for each layer for now for fast lookups
-bool ASVONVolume::IsAnyMemberBlocked(uint8 aLayer, uint64 aCode) const
+void ASVONVolume::RasterizeLeafNode(const FVector& aOrigin, FSVONLeafNode& oLeafNode) const
 {
-	uint64 parentCode = aCode >> 3;
+	const float leafVoxelSize = GetVoxelSize(0) * 0.25f;
 
-	if (aLayer == myBlockedIndices.Num())
-	{
-		return true;
-	}
-	// The parent of this code is blocked
-	if (myBlockedIndices[aLayer].Contains(parentCode))
+	// Each 2x2x2 sub-block is a contiguous run of 8 morton codes. Test it as a whole first, and skip its voxels if it's empty
+	const int blockSize = myUseHierarchicalLeafRasterization ? 8 : 1;
+
+	for (int block = 0; block < 64; block += blockSize)
 	{
-		return true;
+		if (blockSize > 1)
+		{
+			uint32 x, y, z;
+			FSVONMorton::Decode(block / blockSize, x, y, z);
+			FVector position = aOrigin + FVector(x * leafVoxelSize, y * leafVoxelSize, z * leafVoxelSize) * 2.f + FVector(leafVoxelSize);
+
+			if (!IsBlocked(position, leafVoxelSize))
+			{
+				continue;
+			}
+		}
+
+		for (int i = block; i < block + blockSize; i++)
+		{
+			uint32 x, y, z;
+			FSVONMorton::Decode(i, x, y, z);
+			FVector position = aOrigin + FVector(x * leafVoxelSize, y * leafVoxelSize, z * leafVoxelSize) + FVector(leafVoxelSize * 0.5f);
+
+			if (IsBlocked(position, leafVoxelSize * 0.5f))
+			{
+				oLeafNode.SetNode(i);
+			}
+		}
 	}
+}
 
-	return false;
+// First pass blocking test for a whole node, safe to call from worker threads
+bool ASVONVolume::IsNodeBlocked(uint8 aLayer, uint64 aCode) const
+{
+	FVector position;
+	GetNodePosition(aLayer, aCode, position);
+	FCollisionQueryParams params;
+	params.bFindInitialOverlaps = true;
+	params.bTraceComplex = false;
+	params.TraceTag = "SVONFirstPassRasterize";
+
+	return GetWorld()->OverlapBlockingTestByChannel(position, FQuat::Identity, myCollisionChannel, FCollisionShape::MakeBox(FVector(GetVoxelSize(aLayer) * 0.5f)), params);
 }
 
 // World blocking test here, we're using a physics box trace at the moment
@@ -619,132 +721,90 @@ bool ASVONVolume::IsBlocked(const FVector& aPosition, const float aSize) const
 
 bool ASVONVolume::IsInDebugRange(const FVector& aPosition) const
 {
-	return FVector::DistSquared(myDebugPosition, aPosition) < myDebugDistance * myDebugDistance;
+	// Debug drawing is game thread only, so there's none from background generation or worker threads
+	return IsInGameThread() && FVector::DistSquared(myDebugPosition, aPosition) < myDebugDistance * myDebugDistance;
 }
 
 void ASVONVolume::RasterizeLayer(uint8 aLayer)
 {
-	int32 leafIndex = 0;
-	// Layer 0 Leaf nodes are special
-	if (aLayer == 0)
+	// Above the blocked set we need every node in the layer, which is just the root
+	if (aLayer == myBlockedIndices.Num())
 	{
-		// Run through all our coordinates
 		int32 numNodes = GetNumNodesInLayer(aLayer);
 		for (int32 i = 0; i < numNodes; i++)
 		{
-			int index = (i);
-
-			// If we know this node needs to be added, from the low res first pass
-			if (myBlockedIndices[0].Contains(i >> 3))
+			AddLayerNode(aLayer, i);
+		}
+	}
+	// Otherwise, only the 8 children of each blocked parent are added. Parents are sorted, so the layer stays in morton order
+	else
+	{
+		for (const uint64 parentCode : myBlockedIndices[aLayer])
+		{
+			for (uint64 childOffset = 0; childOffset < 8; childOffset++)
 			{
-				// Add a node
-				index = GetLayer(aLayer).Emplace();
-				FSVONNode& node = GetLayer(aLayer)[index];
-
-				// Set my code and position
-				node.myCode = (i);
-
-				FVector nodePos;
-				GetNodePosition(aLayer, node.myCode, nodePos);
-
-				// Debug stuff
-				if (myShowMortonCodes && IsInDebugRange(nodePos))
-				{
-					DrawDebugString(GetWorld(), nodePos, FString::FromInt(aLayer) + ":" + FString::FromInt(index), nullptr, USVONStatics::myLayerColors[aLayer], -1, false);
-				}
-				if (myShowVoxels && IsInDebugRange(nodePos))
-				{
-					DrawDebugBox(GetWorld(), nodePos, FVector(GetVoxelSize(aLayer) * 0.5f), FQuat::Identity, USVONStatics::myLayerColors[aLayer], true, -1.f, 0, .0f);
-				}
+				AddLayerNode(aLayer, (parentCode << 3) | childOffset);
+			}
+		}
+	}
 
-				// Now check if we have any blocking, and search leaf nodes
-				FVector position;
-				GetNodePosition(0, i, position);
+	// Layer 0 Leaf nodes are special, check which have any blocking and rasterize their leaf nodes
+	if (aLayer == 0)
+	{
+		RasterizeLeafNodes();
+	}
+}
 
-				FCollisionQueryParams params;
-				params.bFindInitialOverlaps = true;
-				params.bTraceComplex = false;
-				params.TraceTag = "SVONRasterize";
+void ASVONVolume::AddLayerNode(uint8 aLayer, uint64 aCode)
+{
+	// Add a node
+	TArray<FSVONNode>& layer = myBuildData->GetLayer(aLayer);
+	int32 index = layer.Emplace();
+	FSVONNode& node = layer[index];
+	// Set details
+	node.myCode = aCode;
+
+	int32 childIndex = 0;
+	if (aLayer > 0 && myBuildData->GetIndexForCode(aLayer - 1, node.myCode << 3, childIndex))
+	{
+		// Set parent->child links
+		node.myFirstChild.SetLayerIndex(aLayer - 1);
+		node.myFirstChild.SetNodeIndex(childIndex);
+		// Set child->parent links
+		TArray<FSVONNode>& childLayer = myBuildData->GetLayer(node.myFirstChild.GetLayerIndex());
+		for (int iter = 0; iter < 8; iter++)
+		{
+			childLayer[node.myFirstChild.GetNodeIndex() + iter].myParent.SetLayerIndex(aLayer);
+			childLayer[node.myFirstChild.GetNodeIndex() + iter].myParent.SetNodeIndex(index);
+		}
 
-				if (IsBlocked(position, GetVoxelSize(0) * 0.5f))
-				{
-					// Rasterize my leaf nodes
-					FVector leafOrigin = nodePos - (FVector(GetVoxelSize(aLayer) * 0.5f));
-					RasterizeLeafNode(leafOrigin, leafIndex);
-					node.myFirstChild.SetLayerIndex(0);
-					node.myFirstChild.SetNodeIndex(leafIndex);
-					node.myFirstChild.SetSubnodeIndex(0);
-					leafIndex++;
-				}
-				else
-				{
-					myData.myLeafNodes.AddDefaulted(1);
-					leafIndex++;
-					node.myFirstChild.SetInvalid();
-				}
-			}
+		if (myShowParentChildLinks) // Debug all the things
+		{
+			FVector startPos, endPos;
+			GetNodePosition(aLayer, node.myCode, startPos);
+			GetNodePosition(aLayer - 1, node.myCode << 3, endPos);
+			if (IsInDebugRange(startPos))
+				DrawDebugDirectionalArrow(GetWorld(), startPos, endPos, 0.f, USVONStatics::myLinkColors[aLayer], true);
 		}
 	}
-	// Deal with the other layers
-	else if (GetLayer(aLayer - 1).Num() > 1)
+	else
 	{
-		int nodeCounter = 0;
-		int32 numNodes = GetNumNodesInLayer(aLayer);
-		for (int32 i = 0; i < numNodes; i++)
-		{
-			// Do we have any blocking children, or siblings?
-			// Remember we must have 8 children per parent
-			if (IsAnyMemberBlocked(aLayer, i))
-			{
-				// Add a node
-				int32 index = GetLayer(aLayer).Emplace();
-				nodeCounter++;
-				FSVONNode& node = GetLayer(aLayer)[index];
-				// Set details
-				node.myCode = i;
-				int32 childIndex = 0;
-				if (GetIndexForCode(aLayer - 1, node.myCode << 3, childIndex))
-				{
-					// Set parent->child links
-					node.myFirstChild.SetLayerIndex(aLayer - 1);
-					node.myFirstChild.SetNodeIndex(childIndex);
-					// Set child->parent links, this can probably be done smarter, as we're duplicating work here
-					for (int iter = 0; iter < 8; iter++)
-					{
-						GetLayer(node.myFirstChild.GetLayerIndex())[node.myFirstChild.GetNodeIndex() + iter].myParent.SetLayerIndex(aLayer);
-						GetLayer(node.myFirstChild.GetLayerIndex())[node.myFirstChild.GetNodeIndex() + iter].myParent.SetNodeIndex(index);
-					}
-
-					if (myShowParentChildLinks) // Debug all the things
-					{
-						FVector startPos, endPos;
-						GetNodePosition(aLayer, node.myCode, startPos);
-						GetNodePosition(aLayer - 1, node.myCode << 3, endPos);
-						if (IsInDebugRange(startPos))
-							DrawDebugDirectionalArrow(GetWorld(), startPos, endPos, 0.f, USVONStatics::myLinkColors[aLayer], true);
-					}
-				}
-				else
-				{
-					node.myFirstChild.SetInvalid();
-				}
+		node.myFirstChild.SetInvalid();
+	}
 
-				if (myShowMortonCodes || myShowVoxels)
-				{
-					FVector nodePos;
-					GetNodePosition(aLayer, i, nodePos);
-
-					// Debug stuff
-					if (myShowVoxels && IsInDebugRange(nodePos))
-					{
-						DrawDebugBox(GetWorld(), nodePos, FVector(GetVoxelSize(aLayer) * 0.5f), FQuat::Identity, USVONStatics::myLayerColors[aLayer], true, -1.f, 0, .0f);
-					}
-					if (myShowMortonCodes && IsInDebugRange(nodePos))
-					{
-						DrawDebugString(GetWorld(), nodePos, FString::FromInt(aLayer) + ":" + FString::FromInt(index), nullptr, USVONStatics::myLayerColors[aLayer], -1, false);
-					}
-				}
-			}
+	if (myShowMortonCodes || myShowVoxels)
+	{
+		FVector nodePos;
+		GetNodePosition(aLayer, aCode, nodePos);
+
+		// Debug stuff
+		if (myShowVoxels && IsInDebugRange(nodePos))
+		{
+			DrawDebugBox(GetWorld(), nodePos, FVector(GetVoxelSize(aLayer) * 0.5f), FQuat::Identity, USVONStatics::myLayerColors[aLayer], true, -1.f, 0, .0f);
+		}
+		if (myShowMortonCodes && IsInDebugRange(nodePos))
+		{
+			DrawDebugString(GetWorld(), nodePos, FString::FromInt(aLayer) + ":" + FString::FromInt(index), nullptr, USVONStatics::myLayerColors[aLayer], -1, false);
 		}
 	}
 }
@@ -1,6 +1,7 @@
 // Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
 
 #include "UESVON.h"
+#include "UESVON/Public/SVONMorton.h"
 
 #if WITH_EDITOR
 
@@ -14,6 +15,11 @@ DEFINE_LOG_CATEGORY(VUESVON);
 void FUESVONModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	FSVONMorton::SelectKernel();
+
+#if WITH_EDITOR
+	UE_LOG(UESVON, Display, TEXT("Morton kernel : %s"), FSVONMorton::GetKernelName());
+#endif
 }
 
 void FUESVONModule::ShutdownModule()
@@ -40,12 +40,11 @@ public:
 	/** Switch task into continuous tracking mode: keep restarting move toward goal actor. Only pathfinding failure or external cancel will be able to stop this task. */
 	void SetContinuousGoalTracking(bool bEnable);
 
-	void TickTask(float DeltaTime) override;
-
 protected:
 	void LogPathHelper();
 
-	FThreadSafeBool myAsyncTaskComplete;
+	// The async query we're waiting on, if any
+	FSVONPathQuerySharedPtr myPathQuery;
 	bool myUseAsyncPathfinding;
 
 	UPROPERTY(BlueprintAssignable)
@@ -103,11 +102,13 @@ protected:
 	void CheckPathPreConditions();
 
 	void RequestPathSynchronous();
-	void RequestPathAsync();
+	void RequestPathAsync(bool aUseIncrementalPlanner);
+	void RequestPathIncremental();
+	void CancelPathQuery();
 
 	void RequestMove();
 
-	void HandleAsyncPathTaskComplete();
+	void HandleAsyncPathTaskComplete(const FSVONPathQuerySharedPtr& aQuery);
 
 	void ResetPaths();
 
@@ -1,22 +1,156 @@
 #pragma once
 
+#include "UESVON/Public/SVONDefines.h"
 #include "UESVON/Public/SVONLeafNode.h"
+#include "UESVON/Public/SVONLink.h"
+#include "UESVON/Public/SVONMorton.h"
 #include "UESVON/Public/SVONNode.h"
 #include "SVONData.generated.h"
 
+/**
+ *  One complete, immutable once published, set of navigation data, along with the bounds it was built for.
+		The volume swaps in a new one when it regenerates, and queries hold a reference to the one they started with,
+		so everything below is safe to call from any thread on data that has been published
+ */
 USTRUCT(BlueprintType)
-struct FSVONData
+struct UESVON_API FSVONData
 {
 	GENERATED_BODY()
-	
+
 	// SVO data
 	TArray<TArray<FSVONNode>> myLayers;
 	TArray<FSVONLeafNode> myLeafNodes;
 
+	// Flat ids for every node and leaf subnode, used to index dense per-query arrays. Derived from the layers, not serialized
+	TArray<int32> myLayerIdOffsets;
+	TArray<int32> myLeafIdOffsets;
+	int32 myNumLinkIds = 0;
+
+	// Per layer, whether everything under each node is solid, so coarse searches can treat it as a wall. Derived from the
+	// layers and leaves, not serialized
+	TArray<TBitArray<>> myBlockedNodes;
+
+	// Optional node centre positions, indexed by myPositionOffsets[layer] + node index. Stored as separate x/y/z arrays so
+	// they can be loaded a vector at a time. Derived from the layers and the volume bounds, not serialized
+	TArray<int32> myPositionOffsets;
+	TArray<float, TAlignedHeapAllocator<16>> myPositionsX;
+	TArray<float, TAlignedHeapAllocator<16>> myPositionsY;
+	TArray<float, TAlignedHeapAllocator<16>> myPositionsZ;
+	float myLayerZeroVoxelSize = 0.f;
+
+	// Bounds of the volume the data was built for, not serialized
+	FVector myOrigin = FVector::ZeroVector;
+	FVector myExtent = FVector::ZeroVector;
+
 	void Reset()
 	{
 		myLayers.Empty();
 		myLeafNodes.Empty();
+		myLayerIdOffsets.Empty();
+		myLeafIdOffsets.Empty();
+		myNumLinkIds = 0;
+		myBlockedNodes.Empty();
+		ResetPositionCache();
+	}
+
+	void ResetPositionCache()
+	{
+		myPositionOffsets.Empty();
+		myPositionsX.Empty();
+		myPositionsY.Empty();
+		myPositionsZ.Empty();
+	}
+
+	bool HasPositionCache() const
+	{
+		return myPositionsX.Num() > 0;
+	}
+
+	int32 GetPositionCacheSize() const
+	{
+		return myPositionOffsets.Num() * sizeof(int32) + myPositionsX.Num() * sizeof(float) * 3;
+	}
+
+	// Layer 0 nodes with a leaf get an id for each of their 64 subnodes, every other node gets a single id
+	void BuildLinkIds()
+	{
+		myLayerIdOffsets.SetNumZeroed(myLayers.Num());
+		myLeafIdOffsets.Reset();
+		myNumLinkIds = 0;
+
+		if (myLayers.Num() == 0)
+			return;
+
+		myLeafIdOffsets.SetNumUninitialized(myLayers[0].Num());
+		for (int32 i = 0; i < myLayers[0].Num(); i++)
+		{
+			myLeafIdOffsets[i] = myNumLinkIds;
+			myNumLinkIds += myLayers[0][i].HasChildren() ? 64 : 1;
+		}
+
+		for (int32 i = 1; i < myLayers.Num(); i++)
+		{
+			myLayerIdOffsets[i] = myNumLinkIds;
+			myNumLinkIds += myLayers[i].Num();
+		}
+	}
+
+	// Bottom up, a layer 0 node is blocked if its leaf is completely blocked, and any other node if all 8 of its children are
+	void BuildBlockedNodes()
+	{
+		myBlockedNodes.Reset();
+		myBlockedNodes.SetNum(myLayers.Num());
+
+		for (int32 i = 0; i < myLayers.Num(); i++)
+		{
+			const TArray<FSVONNode>& layer = myLayers[i];
+			myBlockedNodes[i].Init(false, layer.Num());
+
+			for (int32 j = 0; j < layer.Num(); j++)
+			{
+				const FSVONNode& node = layer[j];
+				if (!node.HasChildren())
+					continue;
+
+				bool isBlocked = true;
+				if (i == 0)
+				{
+					isBlocked = myLeafNodes[node.myFirstChild.GetNodeIndex()].IsCompletelyBlocked();
+				}
+				else
+				{
+					for (int32 child = 0; child < 8 && isBlocked; child++)
+					{
+						isBlocked = myBlockedNodes[i - 1][node.myFirstChild.GetNodeIndex() + child];
+					}
+				}
+
+				myBlockedNodes[i][j] = isBlocked;
+			}
+		}
+	}
+
+	bool IsNodeBlocked(const FSVONLink& aLink) const
+	{
+		return myBlockedNodes[aLink.GetLayerIndex()][aLink.GetNodeIndex()];
+	}
+
+	// Fills the position cache from the layers and bounds, which must both be final
+	void BuildPositionCache(bool aForceSingleThread);
+
+	int32 GetLinkId(const FSVONLink& aLink) const
+	{
+		if (aLink.GetLayerIndex() == 0)
+		{
+			return myLeafIdOffsets[aLink.GetNodeIndex()] + aLink.GetSubnodeIndex();
+		}
+
+		return myLayerIdOffsets[aLink.GetLayerIndex()] + aLink.GetNodeIndex();
+	}
+
+	int32 GetNumLinkIds() const
+	{
+		return myNumLinkIds;
 	}
 
 	int GetSize() const
@@ -30,6 +164,56 @@ struct FSVONData
 
 		return result;
 	}
+
+	uint8 GetNumLayers() const
+	{
+		return static_cast<uint8>(myLayers.Num());
+	}
+
+	const TArray<FSVONNode>& GetLayer(uint8 aLayer) const
+	{
+		return myLayers[aLayer];
+	}
+
+	TArray<FSVONNode>& GetLayer(uint8 aLayer)
+	{
+		return myLayers[aLayer];
+	}
+
+	const FVector& GetOrigin() const
+	{
+		return myOrigin;
+	}
+
+	const FVector& GetExtent() const
+	{
+		return myExtent;
+	}
+
+	const FSVONNode& GetNode(const FSVONLink& aLink) const;
+	// Finds the index of the node with the given morton code in a layer, returns false if there isn't one
+	bool GetIndexForCode(uint8 aLayer, uint64 aCode, int32& oIndex) const;
+	const FSVONLeafNode& GetLeafNode(int32 aIndex) const;
+	float GetVoxelSize(uint8 aLayer) const;
+	bool GetNodePosition(uint8 aLayer, uint64 aCode, FVector& oPosition) const;
+	bool GetLinkPosition(const FSVONLink& aLink, FVector& oPosition) const;
+	void GetLeafNeighbours(const FSVONLink& aLink, TArray<FSVONLink>& oNeighbours) const;
+	void GetNeighbours(const FSVONLink& aLink, TArray<FSVONLink>& oNeighbours) const;
+	// Call aVisitor(const FSVONLink&) for each free neighbour, without allocating. For leaf subnodes, and for any other node, respectively
+	template <typename VisitorType>
+	void ForEachLeafNeighbour(const FSVONLink& aLink, VisitorType&& aVisitor) const;
+	template <typename VisitorType>
+	void ForEachNeighbour(const FSVONLink& aLink, VisitorType&& aVisitor) const;
+	// Picks whichever of the above applies to the link
+	template <typename VisitorType>
+	void ForEachLinkNeighbour(const FSVONLink& aLink, VisitorType&& aVisitor) const;
+	// Neighbouring nodes on aLayer or above that aren't completely blocked. Neighbours above aLayer with children are descended into
+	template <typename VisitorType>
+	void ForEachNodeNeighbour(const FSVONLink& aLink, uint8 aLayer, VisitorType&& aVisitor) const;
+	// Whether a voxel is blocked, in leaf resolution coordinates (4 per layer 0 node along each axis). Out of bounds counts as blocked
+	bool IsLeafVoxelBlocked(uint32 aX, uint32 aY, uint32 aZ) const;
+	// As above. If the voxel is clear, also gives the size in leaf voxels of the largest empty node containing it
+	bool IsLeafVoxelBlocked(uint32 aX, uint32 aY, uint32 aZ, uint32& oEmptySize) const;
 };
 
 FORCEINLINE FArchive& operator<<(FArchive& Ar, FSVONData& aSVONData)
@@ -38,4 +222,168 @@ FORCEINLINE FArchive& operator<<(FArchive& Ar, FSVONData& aSVONData)
 	Ar << aSVONData.myLeafNodes;
 
 	return Ar;
-}
\ No newline at end of file
+}
+
+template <typename VisitorType>
+void FSVONData::ForEachLeafNeighbour(const FSVONLink& aLink, VisitorType&& aVisitor) const
+{
+	const uint64 leafIndex = aLink.GetSubnodeIndex();
+	const FSVONNode& node = GetNode(aLink);
+	const FSVONLeafNode& leaf = GetLeafNode(node.myFirstChild.GetNodeIndex());
+
+	for (int i = 0; i < 6; i++)
+	{
+		// Step within the 4x4x4 leaf. If we leave it, this wraps round to the facing subnode of the neighbouring leaf
+		uint64 thisIndex = 0;
+
+		// If the neighbour is in bounds of this leaf node, it's a link as long as it isn't blocked
+		if (FSVONMorton::Step(leafIndex, i, 2, thisIndex))
+		{
+			if (!leaf.GetNode(thisIndex))
+			{
+				aVisitor(FSVONLink(0, aLink.GetNodeIndex(), thisIndex));
+			}
+			continue;
+		}
+
+		// The neighbour is out of bounds, we need to find our neighbour. There isn't one at the edge of the volume
+		const FSVONLink& neighbourLink = node.myNeighbours[i];
+		if (!neighbourLink.IsValid())
+			continue;
+
+		const FSVONNode& neighbourNode = GetNode(neighbourLink);
+
+		// If the neighbour has no leaf node, just return it
+		if (!neighbourNode.HasChildren())
+		{
+			aVisitor(neighbourLink);
+			continue;
+		}
+
+		// Otherwise, the wrapped index is the correct subnode. Only return it if it isn't blocked
+		const FSVONLeafNode& leafNode = GetLeafNode(neighbourNode.myFirstChild.GetNodeIndex());
+		if (!leafNode.GetNode(thisIndex))
+		{
+			aVisitor(FSVONLink(0, neighbourNode.myFirstChild.GetNodeIndex(), thisIndex));
+		}
+	}
+}
+
+template <typename VisitorType>
+void FSVONData::ForEachNeighbour(const FSVONLink& aLink, VisitorType&& aVisitor) const
+{
+	const FSVONNode& node = GetNode(aLink);
+
+	for (int i = 0; i < 6; i++)
+	{
+		const FSVONLink& neighbourLink = node.myNeighbours[i];
+
+		if (!neighbourLink.IsValid())
+			continue;
+
+		const FSVONNode& neighbour = GetNode(neighbourLink);
+
+		// If the neighbour has no children, it's empty, we just use it
+		if (!neighbour.HasChildren())
+		{
+			aVisitor(neighbourLink);
+			continue;
+		}
+
+		// Otherwise, walk down the side of the neighbour facing us. Each layer pops one link and pushes at most 4,
+		// so a fixed stack sized by the layer count is enough
+		TArray<FSVONLink, TFixedAllocator<3 * SVON_MAX_LAYERS + 1>> workingSet;
+		workingSet.Push(neighbourLink);
+
+		while (workingSet.Num() > 0)
+		{
+			const FSVONLink thisLink = workingSet.Pop(false);
+			const FSVONNode& thisNode = GetNode(thisLink);
+
+			if (thisLink.GetLayerIndex() > 0)
+			{
+				// The 4 children facing us. Ones with children of their own need looking into, the rest are clear
+				for (const int32& childIndex : USVONStatics::dirChildOffsets[i])
+				{
+					FSVONLink childLink = thisNode.myFirstChild;
+					childLink.myNodeIndex += childIndex;
+
+					if (GetNode(childLink).HasChildren())
+					{
+						workingSet.Push(childLink);
+					}
+					else
+					{
+						aVisitor(childLink);
+					}
+				}
+			}
+			else
+			{
+				// If this is a leaf layer, then we need to add whichever of the 16 facing leaf nodes aren't blocked
+				const FSVONLeafNode& leafNode = GetLeafNode(thisNode.myFirstChild.GetNodeIndex());
+
+				for (const int32& leafIndex : USVONStatics::dirLeafChildOffsets[i])
+				{
+					if (!leafNode.GetNode(leafIndex))
+					{
+						aVisitor(FSVONLink(0, thisNode.myFirstChild.GetNodeIndex(), leafIndex));
+					}
+				}
+			}
+		}
+	}
+}
+
+template <typename VisitorType>
+void FSVONData::ForEachLinkNeighbour(const FSVONLink& aLink, VisitorType&& aVisitor) const
+{
+	if (aLink.GetLayerIndex() == 0 && GetNode(aLink).HasChildren())
+	{
+		ForEachLeafNeighbour(aLink, Forward<VisitorType>(aVisitor));
+	}
+	else
+	{
+		ForEachNeighbour(aLink, Forward<VisitorType>(aVisitor));
+	}
+}
+
+template <typename VisitorType>
+void FSVONData::ForEachNodeNeighbour(const FSVONLink& aLink, uint8 aLayer, VisitorType&& aVisitor) const
+{
+	const FSVONNode& node = GetNode(aLink);
+
+	for (int i = 0; i < 6; i++)
+	{
+		const FSVONLink& neighbourLink = node.myNeighbours[i];
+
+		if (!neighbourLink.IsValid())
+			continue;
+
+		TArray<FSVONLink, TFixedAllocator<3 * SVON_MAX_LAYERS + 1>> workingSet;
+		workingSet.Push(neighbourLink);
+
+		while (workingSet.Num() > 0)
+		{
+			const FSVONLink thisLink = workingSet.Pop(false);
+			const FSVONNode& thisNode = GetNode(thisLink);
+
+			// Solid all the way down, so there's no way through, or into, anything under it
+			if (IsNodeBlocked(thisLink))
+				continue;
+
+			if (thisLink.GetLayerIndex() <= aLayer || !thisNode.HasChildren())
+			{
+				aVisitor(thisLink);
+				continue;
+			}
+
+			for (const int32& childIndex : USVONStatics::dirChildOffsets[i])
+			{
+				FSVONLink childLink = thisNode.myFirstChild;
+				childLink.myNodeIndex += childIndex;
+				workingSet.Push(childLink);
+			}
+		}
+	}
+}
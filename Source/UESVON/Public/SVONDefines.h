@@ -11,6 +11,9 @@ enum class EBuildTrigger : uint8
 
 #define LEAF_LAYER_INDEX 14;
 
+// Layer indices are 4 bits in FSVONLink, with 15 reserved for invalid links
+#define SVON_MAX_LAYERS 15
+
 UCLASS(BlueprintType)
 class UESVON_API USVONStatics : public UObject
 {
@@ -20,6 +23,8 @@ public:
 	static const FIntVector dirs[];
 	static const int32 dirChildOffsets[6][4];
 	static const int32 dirLeafChildOffsets[6][16];
+	// Centre of each leaf subnode relative to the centre of its layer 0 node, in units of the layer 0 voxel size
+	static const FVector leafSubnodeOffsets[64];
 	static const FColor myLayerColors[];
 	static const FColor myLinkColors[];
 };
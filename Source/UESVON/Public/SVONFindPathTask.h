@@ -1,7 +1,9 @@
 #pragma once
 
+#include "UESVON/Public/SVONIncrementalPlanner.h"
 #include "UESVON/Public/SVONLink.h"
 #include "UESVON/Public/SVONPathFinder.h"
+#include "UESVON/Public/SVONPathQuery.h"
 #include "UESVON/Public/SVONTypes.h"
 
 class FSVONFindPathTask : public FNonAbandonableTask
@@ -9,32 +11,36 @@ class FSVONFindPathTask : public FNonAbandonableTask
 	friend class FAutoDeleteAsyncTask<FSVONFindPathTask>;
 
 public:
-	FSVONFindPathTask(ASVONVolume* aVolume, FSVONPathFinderSettings& aSettings, UWorld* aWorld, const FSVONLink aStart, const FSVONLink aTarget, const FVector& aStartPos, const FVector& aTargetPos, FSVONNavPathSharedPtr* oPath, FThreadSafeBool& aCompleteFlag)
-		: myVolume(aVolume)
-		, myWorld(aWorld)
+	FSVONFindPathTask(const FSVONDataConstPtr& aData, const FSVONPathFinderSettings& aSettings, const FSVONLink aStart, const FSVONLink aTarget, const FVector& aStartPos, const FVector& aTargetPos, const FSVONIncrementalPlannerSharedPtr& aPlanner, const FSVONPathQuerySharedPtr& aQuery, FSVONPathQueryQueue& aFinishedQueue)
+		: myData(aData)
 		, myStart(aStart)
 		, myTarget(aTarget)
 		, myStartPos(aStartPos)
 		, myTargetPos(aTargetPos)
-		, myPath(oPath)
 		, mySettings(aSettings)
-		, myCompleteFlag(aCompleteFlag)
+		, myPlanner(aPlanner)
+		, myQuery(aQuery)
+		, myFinishedQueue(aFinishedQueue)
 	{
 	}
 
 protected:
-	ASVONVolume* myVolume;
-	UWorld* myWorld;
+	// The snapshot the links were found in, kept alive until we finish
+	FSVONDataConstPtr myData;
 
 	FSVONLink myStart;
 	FSVONLink myTarget;
 	FVector myStartPos;
 	FVector myTargetPos;
-	FSVONNavPathSharedPtr* myPath;
 
 	FSVONPathFinderSettings mySettings;
+	// Optional, searches by repairing the planner's last search instead of with a path finder
+	FSVONIncrementalPlannerSharedPtr myPlanner;
 
-	FThreadSafeBool& myCompleteFlag;
+	// Our own reference, so the query outlives us whatever happens to the requester
+	FSVONPathQuerySharedPtr myQuery;
+	// Where we push the query when we're done with it
+	FSVONPathQueryQueue& myFinishedQueue;
 
 	void DoWork();
 
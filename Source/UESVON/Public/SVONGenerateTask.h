@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Async/AsyncWork.h"
+
+class ASVONVolume;
+
+/**
+ *  Builds a volume's navigation data on a worker thread. The volume owns the task, and waits for it if it goes away first
+ */
+class FSVONGenerateTask : public FNonAbandonableTask
+{
+	friend class FAsyncTask<FSVONGenerateTask>;
+
+public:
+	FSVONGenerateTask(ASVONVolume* aVolume)
+		: myVolume(aVolume)
+		, myWeakVolume(aVolume)
+	{
+	}
+
+	/* Passes progress back to the volume on the game thread, called from the worker */
+	void ReportProgress(float aProgress) const;
+
+protected:
+	ASVONVolume* myVolume;
+	// Made on the game thread, and only checked there, to hand the result back
+	TWeakObjectPtr<ASVONVolume> myWeakVolume;
+
+	void DoWork();
+
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FSVONGenerateTask, STATGROUP_ThreadPoolAsyncTasks);
+	}
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "HAL/CriticalSection.h"
+#include "HAL/ThreadSafeBool.h"
+#include "UESVON/Public/SVONLink.h"
+#include "UESVON/Public/SVONNavigationPath.h"
+#include "UESVON/Public/SVONPathFinder.h"
+#include "UESVON/Public/SVONTypes.h"
+
+/**
+ *  Replans one agent's path to a moving goal, repairing the last search instead of starting again (Moving Target D* Lite).
+		The search tree is rooted at the agent and kept between calls. When only the goal moves, the open links just have their
+		priorities shifted. When the agent moves, the tree is re-rooted and only the links that hung off the old root are repaired.
+		The state is sparse, so it only grows with the area actually searched, and is thrown away if the volume or costs change.
+		It always plans A* style over full resolution links, so the search type and hierarchical settings are ignored
+ */
+class UESVON_API FSVONIncrementalPlanner
+{
+public:
+	/* Plans from aStart to aGoal, reusing whatever is still valid from the previous call. Safe from any thread, calls that overlap
+		are run one after the other. If aCancelFlag gets set, gives up without a path, but keeps the tree for the next call */
+	bool FindPath(const FSVONDataConstPtr& aData, const FSVONPathFinderSettings& aSettings, const FSVONLink& aStart, const FSVONLink& aGoal, const FVector& aStartPos, const FVector& aTargetPos, FSVONNavPathSharedPtr* oPath, const FThreadSafeBool* aCancelFlag = nullptr);
+
+	/* Drops the search tree, so the next call plans from scratch. Not to be called while a FindPath is running */
+	void Reset();
+
+	int32 GetNumStates() const { return myStates.Num(); }
+
+private:
+	// Beyond this many links the tree is mostly stale, and costs more to keep than a fresh search would
+	static const int32 MaxStates = 1 << 16;
+
+	static const int CancelCheckInterval = 256;
+
+	struct FKey
+	{
+		float myPrimary = FLT_MAX;
+		float mySecondary = FLT_MAX;
+
+		bool operator<(const FKey& aOther) const { return myPrimary < aOther.myPrimary || (myPrimary == aOther.myPrimary && mySecondary < aOther.mySecondary); }
+		bool operator==(const FKey& aOther) const { return myPrimary == aOther.myPrimary && mySecondary == aOther.mySecondary; }
+	};
+
+	struct FState
+	{
+		float myG = FLT_MAX;
+		float myRhs = FLT_MAX;
+		FSVONLink myParent;
+		FVector myPosition;
+		// The key this link was last queued with. Heap entries with any other key are stale
+		FKey myKey;
+		bool myIsOpen = false;
+	};
+
+	struct FOpenEntry
+	{
+		FKey myKey;
+		FSVONLink myLink;
+
+		bool operator<(const FOpenEntry& aOther) const { return myKey < aOther.myKey; }
+	};
+
+	// Held for the whole of FindPath, so a sync call on the game thread can't run into an async one on a worker
+	FCriticalSection myLock;
+
+	// The data our states were built against. If the volume regenerates, every link we hold is stale
+	FSVONDataConstPtr myData;
+	FSVONPathFinderSettings mySettings;
+	// Supplies the cost model and path building, so we plan with exactly the same costs as a full search
+	FSVONPathFinder myPathFinder;
+
+	TMap<FSVONLink, FState> myStates;
+	// Lazy deletion heap, links are removed or requeued by changing their state, and stale entries skipped when they surface
+	TArray<FOpenEntry> myOpen;
+
+	FSVONLink myStart;
+	FSVONLink myGoal;
+	FVector myGoalPosition;
+	// Accumulated heuristic change from goal moves, added to new keys instead of requeuing everything
+	float myKeyModifier = 0.f;
+
+	int myNumIterations = 0;
+
+	bool NeedsReset(const FSVONDataConstPtr& aData, const FSVONPathFinderSettings& aSettings) const;
+
+	FState& GetState(const FSVONLink& aLink);
+
+	FKey CalculateKey(const FState& aState) const;
+
+	/* Queues, requeues or removes the link depending on whether it's consistent */
+	void UpdateState(const FSVONLink& aLink);
+
+	/* The cheapest way into the link from its neighbours' current g values */
+	void UpdateRhs(const FSVONLink& aLink);
+
+	/* Pops stale entries until the top of the heap is live, returns false if nothing is open */
+	bool PeekOpen(FOpenEntry& oEntry);
+
+	/* Returns false if there's no path, or it was cancelled first. Either way, what's been done so far stays valid */
+	bool ComputePath(const FThreadSafeBool* aCancelFlag);
+};
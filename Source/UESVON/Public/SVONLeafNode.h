@@ -1,6 +1,6 @@
 #pragma once
 
-#include "UESVON/Private/libmorton/morton.h"
+#include "UESVON/Public/SVONMorton.h"
 #include "SVONLeafNode.generated.h"
 
 USTRUCT(BlueprintType)
@@ -12,13 +12,13 @@ struct FSVONLeafNode
 
 	bool GetNodeAt(uint32 aX, uint32 aY, uint32 aZ) const
 	{
-		const uint64 index = libmorton::morton3D_64_encode(aX, aY, aZ);
+		const uint64 index = FSVONMorton::Encode(aX, aY, aZ);
 		return (myVoxelGrid & (1ULL << index)) != 0;
 	}
 
 	void SetNodeAt(uint32 aX, uint32 aY, uint32 aZ)
 	{
-		const uint64 index = libmorton::morton3D_64_encode(aX, aY, aZ);
+		const uint64 index = FSVONMorton::Encode(aX, aY, aZ);
 		myVoxelGrid |= 1ULL << index;
 	}
 
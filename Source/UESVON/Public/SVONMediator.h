@@ -1,6 +1,7 @@
 #pragma once
 #include "SVONMediator.generated.h"
 
+struct FSVONData;
 struct FSVONLink;
 
 UCLASS(BlueprintType)
@@ -14,4 +15,12 @@ public:
 
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category="SVON")
 	static void GetVolumeXYZ(const FVector& aPosition, const class ASVONVolume* aVolume, const int aLayer, FIntVector& oXYZ);
+
+	/* Traces the segment against the nav data, returning true if it hits a blocked voxel, and where it entered it.
+		Only reads the generated data, so it's safe to call from any thread. The segment is clear outside the volume */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category="SVON")
+	static bool Raycast(const FVector& aStart, const FVector& aEnd, const class ASVONVolume* aVolume, FVector& oHitPosition);
+
+	/* As above, against a snapshot of the data. Use this off the game thread, with the snapshot you pinned */
+	static bool Raycast(const FVector& aStart, const FVector& aEnd, const FSVONData& aData, FVector& oHitPosition);
 };
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UESVON/Private/libmorton/morton.h"
+
+// If the compiler is already allowed to emit pdep/pext, libmorton's default is the fastest we'll get. Otherwise we
+// build a BMI2 kernel anyway, and only call it if the CPU we're running on turns out to support it
+#if defined(__BMI2__) || (defined(__AVX2__) && defined(_MSC_VER))
+#define SVON_COMPILED_BMI2 1
+#else
+#define SVON_COMPILED_BMI2 0
+#endif
+
+#define SVON_RUNTIME_BMI2 (PLATFORM_CPU_X86_FAMILY && !SVON_COMPILED_BMI2)
+
+/**
+ *  Morton code arithmetic, working directly on the interleaved bits of a 3D code, so we can step to a neighbour
+		without decoding to x/y/z and encoding again.
+		Encode/Decode call libmorton directly, unless the BMI2 kernel can only be picked at runtime, see SelectKernel
+ */
+struct UESVON_API FSVONMorton
+{
+	static FORCEINLINE uint64 Encode(uint32 aX, uint32 aY, uint32 aZ)
+	{
+#if SVON_RUNTIME_BMI2
+		return EncodeFunction(aX, aY, aZ);
+#else
+		return libmorton::morton3D_64_encode(aX, aY, aZ);
+#endif
+	}
+
+	static FORCEINLINE void Decode(uint64 aCode, uint32& oX, uint32& oY, uint32& oZ)
+	{
+#if SVON_RUNTIME_BMI2
+		DecodeFunction(aCode, oX, oY, oZ);
+#else
+		uint_fast32_t x, y, z;
+		libmorton::morton3D_64_decode(aCode, x, y, z);
+		oX = x;
+		oY = y;
+		oZ = z;
+#endif
+	}
+
+	// Detects BMI2 support once, at module startup. Until then, and on hardware without it, we use the lookup tables
+	static void SelectKernel();
+
+	static const TCHAR* GetKernelName()
+	{
+		return KernelName;
+	}
+
+	// The bits belonging to one axis of a 3D morton code, x is the lowest bit, then y, then z
+	static FORCEINLINE uint64 GetAxisMask(uint8 aAxis)
+	{
+		return 0x1249249249249249ULL << aAxis;
+	}
+
+	// The bits used by a grid of 2^aGridPower nodes per side
+	static FORCEINLINE uint64 GetGridMask(uint8 aGridPower)
+	{
+		return aGridPower >= 21 ? ~0ULL : (1ULL << (aGridPower * 3)) - 1;
+	}
+
+	/* Steps one node from aCode in direction aDir (as USVONStatics::dirs), on a grid of 2^aGridPower nodes per side.
+		If the step leaves the grid, oCode wraps round to the opposite face and we return false */
+	static FORCEINLINE bool Step(uint64 aCode, uint8 aDir, uint8 aGridPower, uint64& oCode)
+	{
+		const uint64 axisMask = GetAxisMask(aDir >> 1) & GetGridMask(aGridPower);
+		const uint64 axisBits = aCode & axisMask;
+
+		if ((aDir & 1) == 0)
+		{
+			// Setting all the other bits carries the increment straight across them
+			oCode = (aCode & ~axisMask) | (((aCode | ~axisMask) + 1) & axisMask);
+			return axisBits != axisMask;
+		}
+		else
+		{
+			// The borrow ripples through the other bits, which we then mask away
+			oCode = (aCode & ~axisMask) | ((axisBits - 1) & axisMask);
+			return axisBits != 0;
+		}
+	}
+
+private:
+#if SVON_RUNTIME_BMI2
+	static uint64 (*EncodeFunction)(uint32, uint32, uint32);
+	static void (*DecodeFunction)(uint64, uint32&, uint32&, uint32&);
+#endif
+	static const TCHAR* KernelName;
+};
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "UESVON/Public/SVONIncrementalPlanner.h"
 #include "UESVON/Public/SVONLink.h"
 #include "UESVON/Public/SVONNavigationPath.h"
 #include "UESVON/Public/SVONTypes.h"
@@ -30,8 +31,25 @@ public:
 	float NodeSizeCompensation = 1.0f;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SVO Navigation | Heuristics")
 	ESVONPathCostType PathCostType = ESVONPathCostType::Euclidean;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SVO Navigation | Heuristics")
+	ESVONPathSearchType PathSearchType = ESVONPathSearchType::AStar;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SVO Navigation | Smoothing")
 	int SmoothingIterations = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SVO Navigation | Smoothing")
+	bool UseStringPulling = false;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SVO Navigation | Hierarchical")
+	bool UseHierarchicalSearch = false;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SVO Navigation | Hierarchical")
+	int32 HierarchicalLayer = 2;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SVO Navigation | Hierarchical")
+	bool ReportHierarchicalQuality = false;
+	// Continuous goal tracking repairs the last search when the goal or pawn moves, instead of searching again from scratch.
+	// The repair is always A* over full resolution links, so PathSearchType and UseHierarchicalSearch don't apply to it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SVO Navigation | Replanning")
+	bool UseIncrementalReplanning = false;
+	// Async requests with a higher priority are served first by the path scheduler
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SVO Navigation | Scheduling")
+	int32 PathRequestPriority = 0;
 
 	// Sets default values for this component's properties
 	USVONNavigationComponent(const FObjectInitializer& ObjectInitializer);
@@ -41,12 +59,20 @@ public:
 	// Get a Nav position
 	FSVONLink GetNavPosition(FVector& aPosition) const;
 	virtual FVector GetPawnPosition() const;
+	// Whether the pawn was on screen recently, the scheduler serves these before anything else of the same priority
+	virtual bool IsPawnVisible() const;
 
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
-	/* This method isn't hooked up at the moment, pending integration with existing systems */
-	bool FindPathAsync(const FVector& aStartPosition, const FVector& aTargetPosition, FThreadSafeBool& aCompleteFlag, FSVONNavPathSharedPtr* oNavPath);
+	/* Queued on the world's path scheduler. The query is completed on the game thread, and can be cancelled until then.
+		Returns null if the request couldn't be made. Any earlier query from this component is cancelled. With
+		aUseIncrementalPlanner, the worker repairs this component's incremental planner rather than searching from scratch */
+	FSVONPathQuerySharedPtr FindPathAsync(const FVector& aStartPosition, const FVector& aTargetPosition, bool aUseIncrementalPlanner = false);
 	bool FindPathImmediate(const FVector& aStartPosition, const FVector& aTargetPosition, FSVONNavPathSharedPtr* oNavPath);
+	/* Synchronous, but keeps its search between calls, so is cheap when start and target have only moved a little since the last one.
+		Waits for any async request that's using the same search */
+	bool FindPathIncremental(const FVector& aStartPosition, const FVector& aTargetPosition, FSVONNavPathSharedPtr* oNavPath);
+	void ResetIncrementalPlanner();
 
 	UFUNCTION(BlueprintCallable, Category = UESVON)
 	void FindPathImmediate(const FVector &aStartPosition, const FVector &aTargetPosition, TArray<FVector>& OutPathPoints);
@@ -68,5 +94,10 @@ protected:
 
 	FSVONNavPathSharedPtr SVONPath;
 
+	// This agent's search state for FindPathIncremental, shared with any async request still using it
+	FSVONIncrementalPlannerSharedPtr IncrementalPlanner;
+
+	FSVONPathFinderSettings GetPathFinderSettings() const;
+
 	mutable FSVONLink LastLocation;
 };
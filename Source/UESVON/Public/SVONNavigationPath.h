@@ -8,6 +8,16 @@ enum class ESVONPathCostType : uint8
 	Euclidean
 };
 
+UENUM(BlueprintType)
+enum class ESVONPathSearchType : uint8
+{
+	AStar UMETA(DisplayName = "A*"),
+	// Any-angle, parents are allowed to be any node in line of sight, so paths come out straight rather than following voxel centres
+	LazyThetaStar UMETA(DisplayName = "Lazy Theta*"),
+	// Searches from both ends at once until they meet, expanding fewer nodes on long routes
+	Bidirectional UMETA(DisplayName = "Bidirectional A*")
+};
+
 USTRUCT(BlueprintType)
 struct FSVONPathPoint
 {
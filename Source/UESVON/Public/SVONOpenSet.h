@@ -0,0 +1,64 @@
+#pragma once
+
+#include "UESVON/Public/SVONLink.h"
+
+/**
+ *  The A* open set. A binary min-heap of links keyed on their f-score. Where each link sits in the heap is kept in a dense
+		array indexed by the link's flat id (see ASVONVolume::GetLinkId), so membership tests and decrease-key are a lookup.
+		The index array is generation stamped, so Reset doesn't have to touch it
+ */
+struct UESVON_API FSVONOpenSet
+{
+	/* Empties the set, ready for links with ids in [0, aNumIds). Keeps its memory for the next search */
+	void Reset(int32 aNumIds);
+
+	bool IsEmpty() const
+	{
+		return myHeap.Num() == 0;
+	}
+
+	int32 Num() const
+	{
+		return myHeap.Num();
+	}
+
+	/* The lowest score in the set, which must not be empty */
+	float PeekScore() const
+	{
+		return myHeap[0].myScore;
+	}
+
+	bool Contains(int32 aId) const
+	{
+		const FHeapSlot& slot = myHeapIndices[aId];
+		return slot.myGeneration == myGeneration && slot.myIndex != INDEX_NONE;
+	}
+
+	/* Adds the link with the given score, or updates its score if it's already in the set */
+	void Push(int32 aId, const FSVONLink& aLink, float aScore);
+
+	/* Removes and returns the link with the lowest score */
+	FSVONLink Pop();
+
+private:
+	struct FEntry
+	{
+		FSVONLink myLink;
+		int32 myId;
+		float myScore;
+	};
+
+	struct FHeapSlot
+	{
+		uint32 myGeneration;
+		int32 myIndex;
+	};
+
+	TArray<FEntry> myHeap;
+	TArray<FHeapSlot> myHeapIndices;
+	uint32 myGeneration = 0;
+
+	void SiftUp(int32 aIndex);
+	void SiftDown(int32 aIndex);
+	void SetEntry(int32 aIndex, const FEntry& aEntry);
+};
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
 #include "SVONLink.h"
 #include "SVONNavigationPath.h"
+#include "UESVON/Public/SVONPathFinderContext.h"
 #include "UESVON/Public/SVONTypes.h"
 #include "SVONPathFinder.generated.h"
 
@@ -22,9 +25,24 @@ struct FSVONPathFinderSettings
 	float myNodeSizeCompensation = 1.f;
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="SVON")
 	int mySmoothingIterations = 0.f;
+	// Drop every path point that the points either side of it can see past, before any smoothing
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="SVON")
+	bool myUseStringPulling = false;
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="SVON")
 	ESVONPathCostType myPathCostType = ESVONPathCostType::Euclidean;
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="SVON")
+	ESVONPathSearchType mySearchType = ESVONPathSearchType::AStar;
+	// Plan over myHierarchicalLayer first, then refine to full resolution only inside the nodes on that coarse route
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="SVON")
+	bool myUseHierarchicalSearch = false;
+	// Higher layers make the coarse search cheaper, but the corridor wider and the route less accurate
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="SVON")
+	int32 myHierarchicalLayer = 2;
+	// Also run the full search, and log the cost of the hierarchical path against it, and how often it falls back. Editor only,
+	// and doubles the query cost
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="SVON")
+	bool myReportHierarchicalQuality = false;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="SVON")
 	TArray<FVector> myDebugPoints;
 };
 
@@ -34,39 +52,87 @@ struct UESVON_API FSVONPathFinder
 	GENERATED_BODY()
 	
 	FSVONPathFinder() {}
-	FSVONPathFinder(ASVONVolume* aVolume, FSVONPathFinderSettings& aSettings) : Volume(aVolume), mySettings(aSettings) {}
+	// Pins the volume's current data, so the search is unaffected if it regenerates part way through
+	FSVONPathFinder(ASVONVolume* aVolume, FSVONPathFinderSettings& aSettings);
+	// Searches the given snapshot, which must be the one the links we're asked for came from
+	FSVONPathFinder(const FSVONDataConstPtr& aData, FSVONPathFinderSettings& aSettings);
 
-	/* Performs an A* search from start to target navlink */
+	/* Performs an A* search from start to target navlink. Must be called on the thread that constructed the pathfinder */
 	int FindPath(const FSVONLink& aStart, const FSVONLink& aTarget, const FVector& aStartPos, const FVector& aTargetPos, FSVONNavPathSharedPtr* oPath);
 
-private:
-	TArray<FSVONLink> myOpenSet;
-	TSet<FSVONLink> myClosedSet;
+	/* The search gives up, and FindPath fails, once this is set. It's checked every CancelCheckInterval iterations */
+	void SetCancelFlag(const FThreadSafeBool* aCancelFlag) { myCancelFlag = aCancelFlag; }
+
+	/* A* heuristic calculation, between the positions of two links */
+	float HeuristicScore(const FVector& aStartPos, const FVector& aTargetPos, const FSVONLink& aTarget) const;
 
-	TMap<FSVONLink, FSVONLink> myCameFrom;
+	/* Distance between the positions of two links */
+	float GetCost(const FVector& aStartPos, const FVector& aTargetPos, const FSVONLink& aTarget) const;
 
-	TMap<FSVONLink, float> myGScore;
-	TMap<FSVONLink, float> myFScore;
+	/* Constructs the path by walking back from aCurrent through aGetCameFrom until it reaches a link with no parent, or its own */
+	void BuildPath(const FSVONLink& aStart, FSVONLink aCurrent, const FVector& aStartPos, const FVector& aTargetPos, TFunctionRef<FSVONLink(const FSVONLink&)> aGetCameFrom, FSVONNavPathSharedPtr* oPath);
 
+private:
 	FSVONLink myStart;
 	FSVONLink myCurrent;
 	FSVONLink myGoal;
+	// Positions of the goal, and of the link being expanded, so we only look them up once
+	FVector myGoalPosition;
+	FVector myCurrentPosition;
+	// Where neighbours of the current link get their path from. The current link itself for A*, its parent for Theta*
+	FSVONLink myExpandFrom;
+	FVector myExpandFromPosition;
 
-	UPROPERTY(VisibleInstanceOnly, Category="SVON")
-	ASVONVolume* Volume = nullptr;
+	// The snapshot of the volume's data we search, held until we're done with it
+	FSVONDataConstPtr myData;
 
 	FSVONPathFinderSettings mySettings;
 
-	/* A* heuristic calculation */
-	float HeuristicScore(const FSVONLink& aStart, const FSVONLink& aTarget);
+	// The search buffers for the thread we were created on
+	FSVONPathFinderContext* myContext = nullptr;
+
+	int myNumIterations = 0;
 
-	/* Distance between two links */
-	float GetCost(const FSVONLink& aStart, const FSVONLink& aTarget);
+	static const int CancelCheckInterval = 256;
+
+	// Hierarchical searches, and how many of them had to fall back to a full search, across all queries. For the quality report
+	static FThreadSafeCounter ourNumHierarchicalSearches;
+	static FThreadSafeCounter ourNumHierarchicalFallbacks;
+	const FThreadSafeBool* myCancelFlag = nullptr;
+
+	bool IsCancelled() const { return myCancelFlag && *myCancelFlag; }
+
+	/* Searches from start to goal, leaving the path in our context's forward scratch. aForEachNeighbour(link, visitor)
+		supplies the neighbours to consider, which is how the flat, coarse and corridor restricted searches differ */
+	template <typename NeighbourFunctionType>
+	bool Search(const FSVONLink& aStart, const FSVONLink& aGoal, ESVONPathSearchType aSearchType, NeighbourFunctionType&& aForEachNeighbour);
+
+	/* Expands from both ends, always the smaller frontier, until no path through the open links could beat the best meeting point */
+	template <typename NeighbourFunctionType>
+	bool SearchBidirectional(const FSVONLink& aStart, const FSVONLink& aGoal, NeighbourFunctionType&& aForEachNeighbour);
+
+	/* Lazy Theta*: the current link was given its parent's parent without checking line of sight. If there isn't any,
+		fall back to the best closed neighbour as A* would have */
+	template <typename NeighbourFunctionType>
+	void SetVertex(NeighbourFunctionType&& aForEachNeighbour);
+
+	/* Raycasts between the two positions against the nav data */
+	bool HasLineOfSight(const FVector& aStartPos, const FVector& aTargetPos) const;
+
+	/* Searches over the coarse layer, then refines inside the corridor it found. Returns false if either step fails */
+	bool SearchHierarchical(const FSVONLink& aStart, const FSVONLink& aGoal);
+
+	/* The link's ancestor on aLayer, or the link itself if it's already on or above it */
+	FSVONLink GetAncestor(FSVONLink aLink, uint8 aLayer) const;
 
 	void ProcessLink(const FSVONLink& aNeighbour);
 
-	/* Constructs the path by navigating back through our CameFrom map */
-	void BuildPath(TMap<FSVONLink, FSVONLink>& aCameFrom, FSVONLink aCurrent, const FVector& aStartPos, const FVector& aTargetPos, FSVONNavPathSharedPtr* oPath);
+	FSVONNodeScratch& GetScratch(const FSVONLink& aLink);
+
+	/* Removes points that aren't needed to keep line of sight along the path */
+	void StringPull(TArray<FSVONPathPoint>& somePoints) const;
 
-	/*void Smooth_Chaikin(TArray<FVector>& somePoints, int aNumIterations);*/
+	/* Chaikin corner cutting. Each iteration replaces every corner with two points a quarter of the way along its edges,
+		unless the cut between them is blocked, in which case the corner stays */
+	void Smooth_Chaikin(TArray<FSVONPathPoint>& somePoints, int aNumIterations);
 };
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "HAL/ThreadSingleton.h"
+#include "UESVON/Public/SVONLink.h"
+#include "UESVON/Public/SVONNavigationPath.h"
+#include "UESVON/Public/SVONOpenSet.h"
+
+/* Per link search state, indexed by the link's flat id. Only valid when myGeneration matches the current search */
+struct FSVONNodeScratch
+{
+	uint32 myGeneration;
+	bool myIsClosed;
+	float myGScore;
+	FSVONLink myCameFrom;
+};
+
+/**
+ *  Everything a path search needs to allocate, kept per thread so the buffers survive between queries.
+		Once a thread has run a search over the largest volume it'll see, further searches don't allocate
+ */
+class UESVON_API FSVONPathFinderContext : public TThreadSingleton<FSVONPathFinderContext>
+{
+	friend class TThreadSingleton<FSVONPathFinderContext>;
+
+public:
+	/* Starts a new search over links with ids in [0, aNumIds). Every scratch entry reads as unvisited without clearing them.
+		A bidirectional search also needs the backward open set and scratch */
+	void Reset(int32 aNumIds, bool aBidirectional = false);
+
+	/* The scratch entry for a link id, initialised to unvisited if it hasn't been touched this search */
+	FORCEINLINE FSVONNodeScratch& GetScratch(int32 aId)
+	{
+		return GetScratch(myScratch, aId);
+	}
+
+	/* As GetScratch, for the search back from the goal in a bidirectional search */
+	FORCEINLINE FSVONNodeScratch& GetBackwardScratch(int32 aId)
+	{
+		return GetScratch(myBackwardScratch, aId);
+	}
+
+	/* Clears the corridor used to restrict a hierarchical search, without touching the stamps */
+	void ResetCorridor(int32 aNumIds);
+
+	void AddToCorridor(int32 aId)
+	{
+		myCorridorStamps[aId] = myCorridorGeneration;
+	}
+
+	bool IsInCorridor(int32 aId) const
+	{
+		return myCorridorStamps[aId] == myCorridorGeneration;
+	}
+
+	FSVONOpenSet myOpenSet;
+	FSVONOpenSet myBackwardOpenSet;
+	TArray<FSVONPathPoint> myPoints;
+	TArray<FSVONPathPoint> mySmoothedPoints;
+
+private:
+	FSVONPathFinderContext() {}
+
+	FORCEINLINE FSVONNodeScratch& GetScratch(TArray<FSVONNodeScratch>& aScratch, int32 aId)
+	{
+		FSVONNodeScratch& scratch = aScratch[aId];
+		if (scratch.myGeneration != myGeneration)
+		{
+			scratch.myGeneration = myGeneration;
+			scratch.myIsClosed = false;
+			scratch.myGScore = FLT_MAX;
+			scratch.myCameFrom = FSVONLink::GetInvalidLink();
+		}
+		return scratch;
+	}
+
+	TArray<FSVONNodeScratch> myScratch;
+	TArray<FSVONNodeScratch> myBackwardScratch;
+	uint32 myGeneration = 0;
+
+	TArray<uint32> myCorridorStamps;
+	uint32 myCorridorGeneration = 0;
+};
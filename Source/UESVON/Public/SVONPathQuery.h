@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Containers/Queue.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/ThreadSafeBool.h"
+#include "UESVON/Public/SVONNavigationPath.h"
+#include "UESVON/Public/SVONTypes.h"
+
+DECLARE_DELEGATE_OneParam(FSVONPathQueryCompleteDelegate, const FSVONPathQuerySharedPtr&);
+
+/**
+ *  An async path query, shared between whoever asked for it, the scheduler and the worker. The worker only ever writes in here,
+		so the requester can let go of it, or be destroyed, at any point without the worker writing into freed memory
+ */
+class UESVON_API FSVONPathQuery
+{
+public:
+	FSVONPathQuery()
+		: myPath(MakeShared<FSVONNavigationPath, ESPMode::ThreadSafe>())
+		, myFinishedEvent(FPlatformProcess::GetSynchEventFromPool(true))
+	{
+	}
+
+	~FSVONPathQuery()
+	{
+		FPlatformProcess::ReturnSynchEventToPool(myFinishedEvent);
+	}
+
+	FSVONPathQuery(const FSVONPathQuery&) = delete;
+	FSVONPathQuery& operator=(const FSVONPathQuery&) = delete;
+
+	/* Asks the worker to give up. It only checks every so often, so may keep going for a moment */
+	void Cancel() { myIsCancelled = true; }
+	bool IsCancelled() const { return myIsCancelled; }
+
+	/* Set on the game thread once the result has been handed back, whether or not a path was found */
+	bool IsComplete() const { return myIsComplete; }
+	bool IsSuccess() const { return myIsSuccess; }
+
+	const FSVONNavPathSharedPtr& GetPath() const { return myPath; }
+
+	// Fired on the game thread when the query completes, unless it was cancelled first
+	FSVONPathQueryCompleteDelegate OnComplete;
+
+private:
+	friend class FSVONFindPathTask;
+	friend class USVONPathScheduler;
+
+	FSVONNavPathSharedPtr myPath;
+
+	FThreadSafeBool myIsCancelled;
+	// Set by the worker once it's done with the query, the scheduler then hands it back when it has the time
+	FThreadSafeBool myIsFinished;
+	// Triggered alongside myIsFinished, so anything that has to wait for the worker can sleep rather than spin
+	FEvent* myFinishedEvent;
+	FThreadSafeBool myIsComplete;
+	bool myIsSuccess = false;
+};
+
+// Finished queries, pushed by any worker and drained by the scheduler on the game thread
+typedef TQueue<FSVONPathQuerySharedPtr, EQueueMode::Mpsc> FSVONPathQueryQueue;
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "UESVON/Public/SVONLink.h"
+#include "UESVON/Public/SVONPathFinder.h"
+#include "UESVON/Public/SVONPathQuery.h"
+#include "UESVON/Public/SVONTypes.h"
+#include "SVONPathScheduler.generated.h"
+
+struct FSVONPathRequest
+{
+	// The volume data the links were found in. A regenerate while we're queued won't pull it out from under the worker
+	FSVONDataConstPtr myData;
+	FSVONPathFinderSettings mySettings;
+	FSVONLink myStart;
+	FSVONLink myTarget;
+	FVector myStartPos;
+	FVector myTargetPos;
+	// If set, the worker repairs this planner's last search rather than searching from scratch
+	FSVONIncrementalPlannerSharedPtr myPlanner;
+	// Where the result goes, and how the requester cancels it
+	FSVONPathQuerySharedPtr myQuery;
+	// Who asked. Only compared, so a newer request from the same owner replaces this one
+	const UObject* myOwner = nullptr;
+	// Higher goes first. Within a priority, agents the player can see go before those they can't
+	int32 myPriority = 0;
+	bool myIsVisible = false;
+	// Arrival order, so requests of equal priority are served first come, first served
+	uint64 mySequence = 0;
+};
+
+/**
+ *  Queues the async path requests for a world, and feeds them to a capped number of worker tasks in priority order.
+		Dispatching and handing back results is limited to a time budget per frame, so a burst of requests is spread over
+		several frames rather than landing on one
+ */
+UCLASS()
+class UESVON_API USVONPathScheduler : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	// Worker tasks allowed to run at once, anything else waits in the queue
+	UPROPERTY(BlueprintReadWrite, Category = "SVON")
+	int32 MaxConcurrentTasks = 4;
+	// Game thread time spent dispatching requests and handing back results each frame
+	UPROPERTY(BlueprintReadWrite, Category = "SVON")
+	float FrameBudgetMs = 0.5f;
+
+	virtual void Deinitialize() override;
+
+	/* Queues a request. Anything the same owner asked for before is cancelled, and if it hadn't started yet, the new request
+		takes its place in the queue, keeping the higher priority */
+	void RequestPath(const FSVONPathRequest& aRequest);
+
+	int32 GetNumPending() const { return myPending.Num(); }
+	int32 GetNumInFlight() const { return myInFlight.Num(); }
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+private:
+	struct FInFlightRequest
+	{
+		FSVONPathQuerySharedPtr myQuery;
+		const UObject* myOwner;
+		FSVONIncrementalPlannerSharedPtr myPlanner;
+	};
+
+	// Heap, ordered by HasPrecedence
+	TArray<FSVONPathRequest> myPending;
+	TArray<FInFlightRequest> myInFlight;
+	// Workers push here when they finish, so we never have to poll the ones still running
+	FSVONPathQueryQueue myFinished;
+
+	uint64 myNextSequence = 0;
+
+	static bool HasPrecedence(const FSVONPathRequest& aRequest, const FSVONPathRequest& aOther);
+
+	/* Hands a query back without a path */
+	static void Abandon(const FSVONPathQuerySharedPtr& aQuery);
+
+	bool IsPlannerInFlight(const FSVONIncrementalPlannerSharedPtr& aPlanner) const;
+
+	/* Hands back finished requests, returns false if we ran out of budget */
+	bool CompleteRequests(double aEndTime);
+
+	void DispatchRequests(double aEndTime);
+};
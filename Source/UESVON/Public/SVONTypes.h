@@ -1,3 +1,7 @@
 #pragma once
 
-typedef TSharedPtr<struct FSVONNavigationPath, ESPMode::ThreadSafe> FSVONNavPathSharedPtr;
\ No newline at end of file
+typedef TSharedPtr<struct FSVONNavigationPath, ESPMode::ThreadSafe> FSVONNavPathSharedPtr;
+typedef TSharedPtr<class FSVONPathQuery, ESPMode::ThreadSafe> FSVONPathQuerySharedPtr;
+typedef TSharedPtr<class FSVONIncrementalPlanner, ESPMode::ThreadSafe> FSVONIncrementalPlannerSharedPtr;
+typedef TSharedPtr<struct FSVONData, ESPMode::ThreadSafe> FSVONDataPtr;
+typedef TSharedPtr<const struct FSVONData, ESPMode::ThreadSafe> FSVONDataConstPtr;
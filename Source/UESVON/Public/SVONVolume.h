@@ -2,9 +2,13 @@
 
 #include "UESVON/Public/SVONData.h"
 #include "UESVON/Public/SVONDefines.h"
+#include "UESVON/Public/SVONGenerateTask.h"
 #include "UESVON/Public/SVONLeafNode.h"
+#include "UESVON/Public/SVONMorton.h"
 #include "UESVON/Public/SVONNode.h"
+#include "UESVON/Public/SVONTypes.h"
 #include "GameFramework/Volume.h"
+#include "HAL/ThreadSafeBool.h"
 #include "SVONVolume.generated.h"
 
 UENUM(BlueprintType)
@@ -14,6 +18,18 @@ enum class ESVOGenerationStrategy : uint8
 	GenerateOnBeginPlay UMETA(DisplayName = "Generate OnBeginPlay")
 };
 
+UENUM(BlueprintType)
+enum class ESVORasterizeStrategy : uint8
+{
+	BottomUp UMETA(DisplayName = "Bottom Up"),
+	TopDown UMETA(DisplayName = "Top Down")
+};
+
+class ASVONVolume;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FSVONGenerationProgressSignature, ASVONVolume*, Volume, float, Progress);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FSVONGenerationCompletedSignature, ASVONVolume*, Volume, bool, Success);
+
 /**
  *  SVONVolume contains the navigation data for the volume, and the methods for generating that data
 		See SVONMediator for public query functions
@@ -28,6 +44,7 @@ public:
 
 	//~ Begin AActor Interface
 	void BeginPlay() override;
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	void PostRegisterAllComponents() override;
 	void PostUnregisterAllComponents() override;
 
@@ -43,25 +60,91 @@ public:
 	//~ End UObject 
 
 	bool Generate();
+	/* Generates on a worker thread and returns straight away, for use during play. The current data stays in use until the new
+		data is published, on the game thread, when OnGenerationCompleted fires. Returns false if we're already generating */
+	bool GenerateAsync();
 	void ClearData();
 
+	bool IsGenerating() const
+	{
+		return myGenerationTask.IsValid();
+	}
+
 	bool IsReadyForNavigation() const;
 
+	/* The published navigation data. Hold on to the pointer for as long as you read from it, a regenerate swaps in a new
+		snapshot, but the one you have stays valid until the last reference to it goes. Safe to call from any thread */
+	FSVONDataConstPtr GetData() const;
+
+	// Game thread shortcuts to the published data. Anything running off the game thread should pin it with GetData instead
 	const TArray<FSVONNode>& GetLayer(uint8 aLayer) const
 	{
-		return myData.myLayers[aLayer];
+		return myData->GetLayer(aLayer);
 	};
-	const FSVONNode& GetNode(const FSVONLink& aLink) const;
-	const FSVONLeafNode& GetLeafNode(int32 aIndex) const;
-	bool GetLinkPosition(const FSVONLink& aLink, FVector& oPosition) const;
+
+	const FSVONNode& GetNode(const FSVONLink& aLink) const
+	{
+		return myData->GetNode(aLink);
+	}
+
+	// Finds the index of the node with the given morton code in a layer, returns false if there isn't one
+	bool GetIndexForCode(uint8 aLayer, uint64 aCode, int32& oIndex) const
+	{
+		return myData->GetIndexForCode(aLayer, aCode, oIndex);
+	}
+
+	const FSVONLeafNode& GetLeafNode(int32 aIndex) const
+	{
+		return myData->GetLeafNode(aIndex);
+	}
+
+	bool GetLinkPosition(const FSVONLink& aLink, FVector& oPosition) const
+	{
+		return myData->GetLinkPosition(aLink, oPosition);
+	}
+
+	// Whether a voxel is blocked, in leaf resolution coordinates (4 per layer 0 node along each axis). Out of bounds counts as blocked
+	bool IsLeafVoxelBlocked(uint32 aX, uint32 aY, uint32 aZ) const
+	{
+		return myData->IsLeafVoxelBlocked(aX, aY, aZ);
+	}
+
+	// As above. If the voxel is clear, also gives the size in leaf voxels of the largest empty node containing it
+	bool IsLeafVoxelBlocked(uint32 aX, uint32 aY, uint32 aZ, uint32& oEmptySize) const
+	{
+		return myData->IsLeafVoxelBlocked(aX, aY, aZ, oEmptySize);
+	}
+
+	// Flat id of a node or leaf subnode, in the range [0, GetNumLinkIds())
+	int32 GetLinkId(const FSVONLink& aLink) const
+	{
+		return myData->GetLinkId(aLink);
+	}
+
+	int32 GetNumLinkIds() const
+	{
+		return myData->GetNumLinkIds();
+	}
+
+	// From the current bounds and voxel power, rather than the published data
 	bool GetNodePosition(uint8 aLayer, uint64 aCode, FVector& oPosition) const;
-	void GetLeafNeighbours(const FSVONLink& aLink, TArray<FSVONLink>& oNeighbours) const;
-	void GetNeighbours(const FSVONLink& aLink, TArray<FSVONLink>& oNeighbours) const;
 	float GetVoxelSize(uint8 aLayer) const;
 
+	// Bounds as of the last UpdateBounds
+	const FVector& GetOrigin() const
+	{
+		return myOrigin;
+	}
+
+	const FVector& GetExtent() const
+	{
+		return myExtent;
+	}
+
+	// Layers in the published data, which lags myNumLayers while we're generating
 	const uint8 GetMyNumLayers() const
 	{
-		return myNumLayers;
+		return myData->GetNumLayers();
 	}
 
 	// Debug Info
@@ -87,42 +170,80 @@ public:
 	float myClearance = 0.f;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UESVON")
 	ESVOGenerationStrategy myGenerationStrategy = ESVOGenerationStrategy::UseBaked;
+	// Bottom up tests every layer 1 node, top down recurses from the root into blocked nodes only. Both produce the same data
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UESVON")
+	ESVORasterizeStrategy myRasterizeStrategy = ESVORasterizeStrategy::BottomUp;
+	// Spread the rasterization overlap tests across worker threads. Output is identical to the serial path
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UESVON")
+	bool myUseParallelRasterization = false;
+	// Test each 2x2x2 block of a leaf node before its individual voxels, skipping blocks that are empty
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UESVON")
+	bool myUseHierarchicalLeafRasterization = false;
+	// Keep the centre of every node in memory, so pathfinding doesn't decode morton codes to get positions. Costs 12 bytes per node
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UESVON")
+	bool myUsePositionCache = false;
+	// With GenerateOnBeginPlay, generate on a worker thread rather than blocking BeginPlay. Not ready for navigation until it's done
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UESVON")
+	bool myGenerateInBackground = false;
+
+	// Fires on the game thread as generation moves through its passes, with progress from 0 to 1
+	UPROPERTY(BlueprintAssignable, Category = "UESVON")
+	FSVONGenerationProgressSignature OnGenerationProgress;
+	// Fires on the game thread once generated data is published, or generation fails
+	UPROPERTY(BlueprintAssignable, Category = "UESVON")
+	FSVONGenerationCompletedSignature OnGenerationCompleted;
 
 	// Generated data attributes
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "UESVON")
 	uint8 myNumLayers = 0;
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "UESVON")
 	int myNumBytes = 0;
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "UESVON")
+	int myNumPositionCacheBytes = 0;
 
 private:
-	// The navigation data
-	FSVONData myData;
-	// temporary data used during nav data generation first pass rasterize
-	TArray<TSet<uint64>> myBlockedIndices;
+	friend class FSVONGenerateTask;
+
+	// The published navigation data, never null. Only ever replaced whole, under myDataLock
+	FSVONDataPtr myData;
+	mutable FCriticalSection myDataLock;
+	// The data being generated, not visible to queries until it's published
+	FSVONDataPtr myBuildData;
+	// Background generation, if it's running. Nothing on the game thread touches the build data until it's done
+	TUniquePtr<FAsyncTask<FSVONGenerateTask>> myGenerationTask;
+	FThreadSafeBool myIsGenerationCancelled;
+	double myGenerationStartTime = 0.0;
+	// temporary data used during nav data generation first pass rasterize. Sorted blocked codes for layers 1 and up
+	TArray<TArray<uint64>> myBlockedIndices;
 	// Helper members
 	FVector myOrigin;
 	FVector myExtent;
 	// Used for defining debug visualiation range
 	FVector myDebugPosition;
 
-	TArray<FSVONNode>& GetLayer(uint8 aLayer)
-	{
-		return myData.myLayers[aLayer];
-	};
-
 	bool myIsReadyForNavigation;
 
 	void UpdateBounds();
-
-	// Generation methods
+	void BuildPositionCache(FSVONData& aData);
+	// Swaps in new data for queries. Ones already running carry on with the snapshot they pinned
+	void PublishData(const FSVONDataPtr& aData);
+
+	// Generation methods. Begin and finish run on the game thread, building the data can run on any
+	void BeginGeneration();
+	bool BuildData();
+	void FinishGeneration();
+	void FinishGenerationAsync(bool aSucceeded);
+	void ReportGenerationProgress(float aProgress);
 	bool FirstPassRasterize();
+	void FirstPassRasterizeTopDown();
 	void RasterizeLayer(uint8 aLayer);
+	void AddLayerNode(uint8 aLayer, uint64 aCode);
 	void BuildNeighbourLinks(uint8 aLayer);
-	bool FindLinkInDirection(uint8 aLayer, const int32 aNodeIndex, uint8 aDir, FSVONLink& oLinkToUpdate, FVector& aStartPosForDebug);
-	void RasterizeLeafNode(FVector& aOrigin, int32 aLeafIndex);
+	bool FindLinkInDirection(uint8 aLayer, const int32 aNodeIndex, uint8 aDir, FSVONLink& oLinkToUpdate, const FVector& aStartPosForDebug) const;
+	void RasterizeLeafNodes();
+	void RasterizeLeafNode(const FVector& aOrigin, FSVONLeafNode& oLeafNode) const;
 
-	bool GetIndexForCode(uint8 aLayer, uint64 aCode, int32& oIndex) const;
-	bool IsAnyMemberBlocked(uint8 aLayer, uint64 aCode) const;
+	bool IsNodeBlocked(uint8 aLayer, uint64 aCode) const;
 	bool IsBlocked(const FVector& aPosition, const float aSize) const;
 	int32 GetNumNodesInLayer(uint8 aLayer) const;
 	int32 GetNumNodesPerSide(uint8 aLayer) const;
@@ -44,8 +44,13 @@ void FSVONVolumeDetails::CustomizeDetails( IDetailLayoutBuilder& DetailBuilder )
 	TSharedPtr<IPropertyHandle> collisionChannelProperty = DetailBuilder.GetProperty("myCollisionChannel");
 	TSharedPtr<IPropertyHandle> clearanceProperty = DetailBuilder.GetProperty("myClearance");
 	TSharedPtr<IPropertyHandle> generationStrategyProperty = DetailBuilder.GetProperty("myGenerationStrategy");
+	TSharedPtr<IPropertyHandle> rasterizeStrategyProperty = DetailBuilder.GetProperty("myRasterizeStrategy");
+	TSharedPtr<IPropertyHandle> parallelRasterizationProperty = DetailBuilder.GetProperty("myUseParallelRasterization");
+	TSharedPtr<IPropertyHandle> hierarchicalLeafRasterizationProperty = DetailBuilder.GetProperty("myUseHierarchicalLeafRasterization");
 	TSharedPtr<IPropertyHandle> numLayersProperty = DetailBuilder.GetProperty("myNumLayers");
 	TSharedPtr<IPropertyHandle> numBytesProperty = DetailBuilder.GetProperty("myNumBytes");
+	TSharedPtr<IPropertyHandle> positionCacheProperty = DetailBuilder.GetProperty("myUsePositionCache");
+	TSharedPtr<IPropertyHandle> positionCacheBytesProperty = DetailBuilder.GetProperty("myNumPositionCacheBytes");
 
 	debugDistanceProperty->SetPropertyDisplayName(NSLOCTEXT("SVO Volume", "Debug Distance", "Debug Distance"));
 	showVoxelProperty->SetPropertyDisplayName(NSLOCTEXT("SVO Volume", "Debug Voxels", "Debug Voxels"));
@@ -59,15 +64,25 @@ void FSVONVolumeDetails::CustomizeDetails( IDetailLayoutBuilder& DetailBuilder )
 	collisionChannelProperty->SetPropertyDisplayName(NSLOCTEXT("SVO Volume", "Collision Channel", "Collision Channel"));
 	clearanceProperty->SetPropertyDisplayName(NSLOCTEXT("SVO Volume", "Clearance", "Clearance"));
 	generationStrategyProperty->SetPropertyDisplayName(NSLOCTEXT("SVO Volume", "Generation Strategy", "Generation Strategy"));
+	rasterizeStrategyProperty->SetPropertyDisplayName(NSLOCTEXT("SVO Volume", "Rasterize Strategy", "Rasterize Strategy"));
+	parallelRasterizationProperty->SetPropertyDisplayName(NSLOCTEXT("SVO Volume", "Parallel Rasterization", "Parallel Rasterization"));
+	hierarchicalLeafRasterizationProperty->SetPropertyDisplayName(NSLOCTEXT("SVO Volume", "Hierarchical Leaf Rasterization", "Hierarchical Leaf Rasterization"));
 	numLayersProperty->SetPropertyDisplayName(NSLOCTEXT("SVO Volume", "Num Layers", "Num Layers"));
 	numBytesProperty->SetPropertyDisplayName(NSLOCTEXT("SVO Volume", "Num Bytes", "Num Bytes"));
+	positionCacheProperty->SetPropertyDisplayName(NSLOCTEXT("SVO Volume", "Position Cache", "Position Cache"));
+	positionCacheBytesProperty->SetPropertyDisplayName(NSLOCTEXT("SVO Volume", "Position Cache Bytes", "Position Cache Bytes"));
 
 	navigationCategory.AddProperty(voxelPowerProperty);
 	navigationCategory.AddProperty(collisionChannelProperty);
 	navigationCategory.AddProperty(clearanceProperty);
 	navigationCategory.AddProperty(generationStrategyProperty);
+	navigationCategory.AddProperty(rasterizeStrategyProperty);
+	navigationCategory.AddProperty(parallelRasterizationProperty);
+	navigationCategory.AddProperty(hierarchicalLeafRasterizationProperty);
 	navigationCategory.AddProperty(numLayersProperty);
 	navigationCategory.AddProperty(numBytesProperty);
+	navigationCategory.AddProperty(positionCacheProperty);
+	navigationCategory.AddProperty(positionCacheBytesProperty);
 
 	const TArray< TWeakObjectPtr<UObject> >& SelectedObjects = DetailBuilder.GetSelectedObjects();
 